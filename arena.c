@@ -0,0 +1,64 @@
+#include "arena.h"
+#include <stdlib.h>
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t size;
+    long long data[];           // Keeps the data 8-byte aligned
+};
+
+#define ARENA_MIN_BLOCK (64 * 1024)
+
+static ArenaBlock *new_block(size_t size, ArenaBlock *next) {
+    ArenaBlock *block = (ArenaBlock *)malloc(sizeof(ArenaBlock) + size);
+    if (block != NULL) {
+        block->next = next;
+        block->size = size;
+    }
+    return block;
+}
+
+void arena_init(Arena *arena) {
+    arena->blocks = NULL;
+    arena->used = 0;
+    arena->total = 0;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    size = (size + 7) & ~(size_t)7;
+    
+    if (arena->blocks == NULL || arena->blocks->size - arena->used < size) {
+        size_t block_size = size > ARENA_MIN_BLOCK ? size : ARENA_MIN_BLOCK;
+        ArenaBlock *block = new_block(block_size, arena->blocks);
+        if (block == NULL) {
+            return NULL;
+        }
+        arena->blocks = block;
+        arena->used = 0;
+    }
+    
+    void *memory = (char *)arena->blocks->data + arena->used;
+    arena->used += size;
+    arena->total += size;
+    return memory;
+}
+
+void arena_reset(Arena *arena) {
+    if (arena->blocks != NULL && arena->blocks->next != NULL) {
+        size_t total = arena->total;
+        arena_free(arena);
+        arena->blocks = new_block(total, NULL);
+    }
+    arena->used = 0;
+    arena->total = 0;
+}
+
+void arena_free(Arena *arena) {
+    while (arena->blocks != NULL) {
+        ArenaBlock *next = arena->blocks->next;
+        free(arena->blocks);
+        arena->blocks = next;
+    }
+    arena->used = 0;
+    arena->total = 0;
+}
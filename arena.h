@@ -0,0 +1,29 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator for per-run scratch memory. Allocations are only released
+// all at once by arena_reset(), which keeps the memory for the next run, so
+// a thread that runs the same kind of simulation repeatedly stops calling
+// malloc after the first run.
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct {
+    ArenaBlock *blocks;         // Most recent block first
+    size_t used;                // Bytes used in the first block
+    size_t total;               // Bytes handed out since the last reset
+} Arena;
+
+void arena_init(Arena *arena);
+
+// Returns 8-byte aligned memory, or NULL when out of memory
+void *arena_alloc(Arena *arena, size_t size);
+
+// Releases every allocation. If the last run needed more than one block,
+// they are replaced by a single block big enough for all of it.
+void arena_reset(Arena *arena);
+
+void arena_free(Arena *arena);
+
+#endif
@@ -0,0 +1,161 @@
+#include "arrivals.h"
+#include "heap.h"
+#include "workload.h"
+
+int arrivals_init(Arrivals *arrivals, const Workload *workload, RunState *state) {
+    int n = workload->n;
+    memset(arrivals, 0, sizeof(Arrivals));
+    arrivals->n = n;
+    arrivals->arrival_time = workload->arrival_time;
+    arrivals->workload = workload;
+    arrivals->state = state;
+    
+    // The workload's shared index when it has one, otherwise a copy built
+    // for this run alone
+    arrivals->order = workload->arrival_order;
+    if (arrivals->order == NULL) {
+        Workload copy = *workload;
+        if (workload_index(&copy) != WORKLOAD_OK) {
+            return -1;
+        }
+        arrivals->order = copy.arrival_order;
+    }
+    if (workload->bursts == NULL) {
+        return 0;
+    }
+    
+    size_t count = n > 0 ? n : 1;
+    arrivals->position = (int *)calloc(count, sizeof(int));
+    arrivals->woken = (int *)malloc(count * sizeof(int));
+    arrivals->batch = (int *)malloc(count * sizeof(int));
+    arrivals->ready_since = (long long *)malloc(count * sizeof(long long));
+    arrivals->cpu_burst = (long long *)malloc(count * sizeof(long long));
+    arrivals->wheel = (TimerWheel *)malloc(sizeof(TimerWheel));
+    if (arrivals->wheel != NULL && timer_wheel_init(arrivals->wheel, n) != 0) {
+        timer_wheel_free(arrivals->wheel);
+        free(arrivals->wheel);
+        arrivals->wheel = NULL;
+    }
+    if (arrivals->position == NULL || arrivals->woken == NULL || arrivals->batch == NULL ||
+        arrivals->ready_since == NULL || arrivals->cpu_burst == NULL || arrivals->wheel == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        arrivals->ready_since[i] = workload->arrival_time[i];
+        arrivals->cpu_burst[i] = workload->bursts[workload->burst_start[i]];
+    }
+    return 0;
+}
+
+void arrivals_free(Arrivals *arrivals) {
+    if (arrivals->order != arrivals->workload->arrival_order) {
+        free((int *)arrivals->order);
+    }
+    if (arrivals->wheel != NULL) {
+        timer_wheel_free(arrivals->wheel);
+        free(arrivals->wheel);
+    }
+    free(arrivals->position);
+    free(arrivals->woken);
+    free(arrivals->batch);
+    free(arrivals->ready_since);
+    free(arrivals->cpu_burst);
+    memset(arrivals, 0, sizeof(Arrivals));
+}
+
+long long arrivals_next_wakeup(const Arrivals *arrivals) {
+    if (arrivals->woken_size > 0) {
+        return arrivals->wheel->expiry[arrivals->woken[arrivals->woken_front]];
+    }
+    return timer_wheel_next(arrivals->wheel);
+}
+
+// Charges the time since the last event to the I/O totals: busy while any
+// process is blocked, overlapped while some other process could run
+static void account(Arrivals *arrivals, long long t) {
+    long long elapsed = t - arrivals->clock;
+    if (arrivals->blocked > 0 && elapsed > 0) {
+        arrivals->state->io_busy_time += elapsed;
+        if (arrivals->blocked < arrivals->live) {
+            arrivals->state->io_overlap_time += elapsed;
+        }
+    }
+    arrivals->clock = t;
+}
+
+// Replays arrivals and expiries up to now in time order, for the accounting,
+// and moves expired processes to the woken ring
+static void advance(Arrivals *arrivals, long long now) {
+    int n = arrivals->n;
+    while (1) {
+        long long arrival = LLONG_MAX;
+        if (arrivals->counted < n) {
+            arrival = arrivals->arrival_time[arrivals->order[arrivals->counted]];
+        }
+        long long wakeup = timer_wheel_next(arrivals->wheel);
+        if (arrival > now && wakeup > now) {
+            break;
+        }
+        if (arrival <= wakeup) {
+            account(arrivals, arrival);
+            arrivals->live++;
+            arrivals->counted++;
+            continue;
+        }
+    
+        account(arrivals, wakeup);
+        int expired = 0;
+        int i;
+        while ((i = timer_wheel_expire(arrivals->wheel, wakeup)) != -1) {
+            arrivals->batch[expired++] = i;
+        }
+        if (expired > 1) {
+            qsort(arrivals->batch, expired, sizeof(int), compare_int);
+        }
+        for (int k = 0; k < expired; k++) {
+            arrivals->woken[(arrivals->woken_front + arrivals->woken_size++) % n] = arrivals->batch[k];
+        }
+        arrivals->blocked -= expired;
+    }
+    account(arrivals, now);
+}
+
+int arrivals_pop_any(Arrivals *arrivals, long long now) {
+    advance(arrivals, now);
+    
+    long long arrival = LLONG_MAX;
+    if (arrivals->next_arrival < arrivals->n) {
+        arrival = arrivals->arrival_time[arrivals->order[arrivals->next_arrival]];
+    }
+    if (arrival <= now && (arrivals->woken_size == 0 || arrival <= arrivals_next_wakeup(arrivals))) {
+        return arrivals->order[arrivals->next_arrival++];
+    }
+    if (arrivals->woken_size == 0) {
+        return -1;
+    }
+    int i = arrivals->woken[arrivals->woken_front];
+    arrivals->woken_front = (arrivals->woken_front + 1) % arrivals->n;
+    arrivals->woken_size--;
+    arrivals->ready_since[i] = arrivals->wheel->expiry[i];
+    return i;
+}
+
+int arrivals_block(Arrivals *arrivals, int i, long long now) {
+    const Workload *workload = arrivals->workload;
+    RunState *state = arrivals->state;
+    advance(arrivals, now);
+    
+    long long at = workload->burst_start[i] + arrivals->position[i];
+    if (at + 1 == workload->burst_start[i + 1]) {
+        state->completion_time[i] = now;
+        arrivals->live--;
+        return 1;
+    }
+    arrivals->position[i] += 2;
+    arrivals->cpu_burst[i] = workload->bursts[at + 2];
+    state->remaining_time[i] = arrivals->cpu_burst[i];
+    state->completion_time[i] = 0;
+    arrivals->blocked++;
+    timer_wheel_arm(arrivals->wheel, i, now + workload->bursts[at + 1]);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#ifndef ARRIVALS_H
+#define ARRIVALS_H
+
+#include "scheduling.h"
+#include "timerwheel.h"
+
+// Processes becoming ready, in time order. Every algorithm admits processes
+// through this stream. Without burst sequences it is a cursor over the
+// arrival order, and each call below is a few inlined instructions.
+//
+// With burst sequences, a process that ends a CPU burst with more to go is
+// blocked for the I/O burst that follows. Its wakeup is a timer on a
+// hierarchical timing wheel, and when the timer expires the process comes
+// back with its next CPU burst as remaining_time. Processes that become
+// ready at the same time come out arrivals first, then wakeups by index.
+// The stream also keeps the run's I/O accounting. Every algorithm keeps the
+// CPU busy while any process is ready, so the CPU is idle exactly when every
+// process in the system is blocked.
+typedef struct {
+    int n;
+    const long long *arrival_time;
+    const int *order;                   // Shared arrival order, or a copy owned by the stream
+    int next_arrival;
+    const Workload *workload;
+    RunState *state;
+
+    // Burst sequences only; position is NULL without them
+    int *position;                      // Offset of each process's current CPU burst in its sequence
+    TimerWheel *wheel;                  // Blocked processes, expiring at the end of their I/O burst
+    int *woken;                         // Ring of n: expired processes not yet handed out
+    int woken_front;
+    int woken_size;
+    int *batch;                         // Wakeups that expire together, sorted by index
+    long long *ready_since;             // When each process last became ready
+    long long *cpu_burst;               // Each process's current CPU burst
+    long long clock;                    // The I/O accounting has reached this time
+    int counted;                        // Arrivals the accounting has seen
+    int live;                           // Arrived and not complete
+    int blocked;                        // In an I/O burst
+} Arrivals;
+
+// Call after run_state_reset(). Returns 0, or -1 when out of memory; call
+// arrivals_free() either way.
+int arrivals_init(Arrivals *arrivals, const Workload *workload, RunState *state);
+void arrivals_free(Arrivals *arrivals);
+
+long long arrivals_next_wakeup(const Arrivals *arrivals);
+int arrivals_pop_any(Arrivals *arrivals, long long now);
+int arrivals_block(Arrivals *arrivals, int i, long long now);
+
+// Time the next process becomes ready, LLONG_MAX when none will
+static inline long long arrivals_next(const Arrivals *arrivals) {
+    long long next = LLONG_MAX;
+    if (arrivals->next_arrival < arrivals->n) {
+        next = arrivals->arrival_time[arrivals->order[arrivals->next_arrival]];
+    }
+    if (arrivals->position != NULL) {
+        long long wakeup = arrivals_next_wakeup(arrivals);
+        if (wakeup < next) {
+            next = wakeup;
+        }
+    }
+    return next;
+}
+
+// Next process ready by now, or -1. now must never move backwards.
+static inline int arrivals_pop(Arrivals *arrivals, long long now) {
+    if (arrivals->position != NULL) {
+        return arrivals_pop_any(arrivals, now);
+    }
+    if (arrivals->next_arrival < arrivals->n && arrivals->arrival_time[arrivals->order[arrivals->next_arrival]] <= now) {
+        return arrivals->order[arrivals->next_arrival++];
+    }
+    return -1;
+}
+
+// Length of process i's current CPU burst
+static inline long long arrivals_burst(const Arrivals *arrivals, int i) {
+    if (arrivals->position != NULL) {
+        return arrivals->cpu_burst[i];
+    }
+    return arrivals->workload->burst_time[i];
+}
+
+// Process i ended a CPU burst at now. Returns 1 when that was its last, with
+// its completion time set, or 0 when it blocked for I/O.
+static inline int arrivals_finish(Arrivals *arrivals, int i, long long now) {
+    if (arrivals->position != NULL) {
+        return arrivals_block(arrivals, i, now);
+    }
+    arrivals->state->completion_time[i] = now;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,448 @@
+// Benchmark harness: times every algorithm on generated workloads from
+// n = 10^2 up to --max-n and prints one record per (algorithm, n).
+//
+// Each measurement runs in a forked child, so the peak RSS it reports belongs
+// to that algorithm and size alone (it includes the workload itself). The
+// output is JSON lines by default, or CSV with --csv, for comparing runs
+// across commits.
+//
+// With --incremental, each record times incremental_update() after a
+// random single-job edit instead of a full run, for the algorithms that
+// support it. With --select, it times one selection scan (select.h) at a
+// decision point halfway through the run, once per kernel set the CPU has,
+// for SJF, Priority, HRRN and LJF.
+
+#include "scheduling.h"
+#include "generate.h"
+#include "incremental.h"
+#include "rng.h"
+#include "select.h"
+#include "workload.h"
+#include <math.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    GeneratorConfig generator;
+    long long time_quantum;
+    double min_seconds;         // Repeat runs until at least this much time
+    int min_n;
+    int max_n;
+    int csv;
+    int incremental;
+    int select;
+    int isa;                    // Kernel set timed with --select
+    int algorithms[ALGORITHM_COUNT];
+    int algorithm_count;
+} BenchOptions;
+
+typedef struct {
+    int status;                 // 0, or -1 if the child failed
+    int runs;
+    double seconds;             // Per run
+    double dispatches;          // Scheduling decisions per run, 0 when not counted
+    long peak_rss_kb;
+} BenchResult;
+
+static const char *short_names[ALGORITHM_COUNT] = {
+    "fcfs", "sjf", "srjf", "rr", "priority", "hrrn", "ljf", "lrjf", "cfs", "lottery", "stride",
+    "priority-aging", "edf", "rm", "mlfq"
+};
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Times single-job edits: each lengthens a random job's burst by 1 to 10
+// and re-simulates. The full run in incremental_init() is not timed. The
+// decisions of an edit are the ones it re-simulated.
+static int measure_edits(const BenchOptions *options, int algorithm, const Workload *workload,
+                         BenchResult *result) {
+    Incremental inc;
+    ScheduleOptions schedule;
+    schedule_options_init(&schedule, options->time_quantum);
+    if (incremental_init(&inc, algorithm, workload, &schedule) != INCREMENTAL_OK) {
+        incremental_free(&inc);
+        return -1;
+    }
+    
+    Rng rng;
+    rng_seed(&rng, options->generator.seed);
+    double start = wall_seconds();
+    double elapsed;
+    long long replayed = 0;
+    do {
+        int i = (int)rng_below(&rng, (unsigned long long)workload->n);
+        Process process;
+        memset(&process, 0, sizeof(Process));
+        process.pid = inc.pid[i];
+        process.arrival_time = inc.arrival_time[i];
+        process.burst_time = inc.burst_time[i] + 1 + (long long)rng_below(&rng, 10);
+        process.priority = inc.priority[i];
+        incremental_set(&inc, i, &process);
+        incremental_update(&inc);
+        replayed += inc.replayed;
+        result->runs++;
+        elapsed = wall_seconds() - start;
+    } while (elapsed < options->min_seconds);
+    result->seconds = elapsed / result->runs;
+    result->dispatches = (double)replayed / result->runs;
+    incremental_free(&inc);
+    return 0;
+}
+
+// Times select_next_with() at the decision point where the job halfway
+// through the arrival order completes, with the completions up to then
+static int measure_scans(const BenchOptions *options, int algorithm, const Workload *workload,
+                         RunState *state, BenchResult *result) {
+    int n = workload->n;
+    if (run_schedule(algorithm, workload, state, options->time_quantum) != SCHEDULE_OK) {
+        return -1;
+    }
+    long long now = state->completion_time[workload->arrival_order[n / 2]];
+    long long *completion_time = (long long *)malloc(n * sizeof(long long));
+    if (completion_time == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        completion_time[i] = state->completion_time[i] <= now ? state->completion_time[i] : 0;
+    }
+    
+    double start = wall_seconds();
+    double elapsed;
+    int status = 0;
+    do {
+        if (select_next_with(algorithm, options->isa, workload, completion_time, now) < SELECT_NONE) {
+            status = -1;
+        }
+        result->runs++;
+        elapsed = wall_seconds() - start;
+    } while (elapsed < options->min_seconds);
+    result->seconds = elapsed / result->runs;
+    result->dispatches = 1;
+    free(completion_time);
+    return status;
+}
+
+// Generates the workload and times the algorithm on it, in the child
+static BenchResult measure(const BenchOptions *options, int algorithm, int n) {
+    BenchResult result = { -1, 0, 0, 0, 0 };
+    GeneratorConfig config = options->generator;
+    config.n = n;
+    
+    ProcessList processes;
+    Workload workload;
+    RunState state;
+    process_list_init(&processes);
+    if (generate_processes(&config, &processes) != 0) {
+        return result;
+    }
+    int loaded = workload_from_processes(&workload, processes.items, n);
+    process_list_free(&processes);
+    if (loaded != WORKLOAD_OK) {
+        return result;
+    }
+    if (workload_index(&workload) != WORKLOAD_OK || run_state_init(&state, n) != 0) {
+        workload_free(&workload);
+        return result;
+    }
+    
+    if (options->incremental) {
+        result.status = measure_edits(options, algorithm, &workload, &result);
+    } else if (options->select) {
+        result.status = measure_scans(options, algorithm, &workload, &state, &result);
+    } else {
+        double start = wall_seconds();
+        double elapsed;
+        do {
+            run_schedule(algorithm, &workload, &state, options->time_quantum);
+            result.runs++;
+            elapsed = wall_seconds() - start;
+        } while (elapsed < options->min_seconds);
+        result.status = 0;
+        result.seconds = elapsed / result.runs;
+        result.dispatches = (double)state.counters.dispatches;
+    }
+    
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.peak_rss_kb = usage.ru_maxrss;
+    
+    run_state_free(&state);
+    workload_free(&workload);
+    return result;
+}
+
+static BenchResult measure_in_child(const BenchOptions *options, int algorithm, int n) {
+    BenchResult result = { -1, 0, 0, 0, 0 };
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return result;
+    }
+    if (child == 0) {
+        close(fds[0]);
+        result = measure(options, algorithm, n);
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == (ssize_t)sizeof(result) ? 0 : 1);
+    }
+    
+    close(fds[1]);
+    if (read(fds[0], &result, sizeof(result)) != (ssize_t)sizeof(result)) {
+        result.status = -1;
+    }
+    close(fds[0]);
+    waitpid(child, NULL, 0);
+    return result;
+}
+
+static void print_result(const BenchOptions *options, int algorithm, int n,
+                         const BenchResult *result, double scaling) {
+    char name[32];
+    if (options->select) {
+        snprintf(name, sizeof(name), "%s-scan-%s", short_names[algorithm - 1], select_isa_name(options->isa));
+    } else {
+        snprintf(name, sizeof(name), "%s%s", short_names[algorithm - 1], options->incremental ? "-edit" : "");
+    }
+    double ns_per_job = result->seconds * 1e9 / n;
+    double ns_per_dispatch = result->dispatches > 0 ? result->seconds * 1e9 / result->dispatches : NAN;
+    
+    if (options->csv) {
+        if (result->status != 0) {
+            printf("%s,%d,,,,,,\n", name, n);
+            return;
+        }
+        printf("%s,%d,%d,%.9f,%.2f,", name, n, result->runs, result->seconds, ns_per_job);
+        if (!isnan(ns_per_dispatch)) {
+            printf("%.2f", ns_per_dispatch);
+        }
+        printf(",%ld,", result->peak_rss_kb);
+        if (!isnan(scaling)) {
+            printf("%.3f", scaling);
+        }
+        printf("\n");
+    } else if (result->status != 0) {
+        printf("{\"algorithm\":\"%s\",\"n\":%d,\"error\":\"run failed\"}\n", name, n);
+    } else {
+        printf("{\"algorithm\":\"%s\",\"n\":%d,\"runs\":%d,\"seconds\":%.9f,\"ns_per_job\":%.2f,"
+               "\"ns_per_dispatch\":", name, n, result->runs, result->seconds, ns_per_job);
+        if (isnan(ns_per_dispatch)) {
+            printf("null");
+        } else {
+            printf("%.2f", ns_per_dispatch);
+        }
+        printf(",\"peak_rss_kb\":%ld,\"scaling\":", result->peak_rss_kb);
+        if (isnan(scaling)) {
+            printf("null}\n");
+        } else {
+            printf("%.3f}\n", scaling);
+        }
+    }
+}
+
+static void print_usage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --max-n N            Largest workload (default 1000000)\n");
+    printf("  --min-n N            Smallest workload (default 100)\n");
+    printf("  --seed S             Generator seed (default 1)\n");
+    printf("  --load L             Offered load (default 0.9)\n");
+    printf("  --bursts KIND        pareto (default) or lognormal\n");
+    printf("  --burst-mean M       Mean burst time (default 20)\n");
+    printf("  --burst-shape S      Pareto alpha or lognormal sigma (default 1.5 / 1.0)\n");
+    printf("  --priorities KIND    uniform (default), zipf or constant\n");
+    printf("  --levels K           Priority levels (default 10)\n");
+    printf("  --algorithms LIST    Menu numbers to run, e.g. 1,2,6 (default all)\n");
+    printf("  --quantum Q          Round Robin, Lottery, Stride and MLFQ quantum (default 10)\n");
+    printf("  --min-time SEC       Minimum timed duration per record (default 0.2)\n");
+    printf("  --incremental        Time single-job edits with incremental re-simulation\n");
+    printf("                       (FCFS, SJF, Priority, HRRN and LJF)\n");
+    printf("  --select             Time one selection scan per kernel set instead of a run\n");
+    printf("                       (SJF, Priority, HRRN and LJF)\n");
+    printf("  --csv                CSV instead of JSON lines\n");
+}
+
+static int parse_options(int argc, char **argv, BenchOptions *options) {
+    generator_defaults(&options->generator, 0, 1);
+    options->time_quantum = 10;
+    options->min_seconds = 0.2;
+    options->min_n = 100;
+    options->max_n = 1000000;
+    options->csv = 0;
+    options->incremental = 0;
+    options->select = 0;
+    options->isa = SELECT_SCALAR;
+    options->algorithm_count = ALGORITHM_COUNT;
+    for (int a = 0; a < ALGORITHM_COUNT; a++) {
+        options->algorithms[a] = a + 1;
+    }
+    int shape_given = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--csv") == 0) {
+            options->csv = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--incremental") == 0) {
+            options->incremental = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--select") == 0) {
+            options->select = 1;
+            continue;
+        }
+        if (value == NULL) {
+            return -1;
+        }
+        i++;
+        
+        if (strcmp(argv[i - 1], "--max-n") == 0) {
+            options->max_n = atoi(value);
+        } else if (strcmp(argv[i - 1], "--min-n") == 0) {
+            options->min_n = atoi(value);
+        } else if (strcmp(argv[i - 1], "--seed") == 0) {
+            options->generator.seed = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--load") == 0) {
+            options->generator.load = atof(value);
+        } else if (strcmp(argv[i - 1], "--bursts") == 0) {
+            if (strcmp(value, "pareto") == 0) {
+                options->generator.burst_distribution = BURST_PARETO;
+            } else if (strcmp(value, "lognormal") == 0) {
+                options->generator.burst_distribution = BURST_LOGNORMAL;
+            } else {
+                return -1;
+            }
+        } else if (strcmp(argv[i - 1], "--burst-mean") == 0) {
+            options->generator.burst_mean = atof(value);
+        } else if (strcmp(argv[i - 1], "--burst-shape") == 0) {
+            options->generator.burst_shape = atof(value);
+            shape_given = 1;
+        } else if (strcmp(argv[i - 1], "--priorities") == 0) {
+            if (strcmp(value, "uniform") == 0) {
+                options->generator.priority_distribution = PRIORITY_UNIFORM;
+            } else if (strcmp(value, "zipf") == 0) {
+                options->generator.priority_distribution = PRIORITY_ZIPF;
+            } else if (strcmp(value, "constant") == 0) {
+                options->generator.priority_distribution = PRIORITY_CONSTANT;
+            } else {
+                return -1;
+            }
+        } else if (strcmp(argv[i - 1], "--levels") == 0) {
+            options->generator.priority_levels = atoi(value);
+        } else if (strcmp(argv[i - 1], "--algorithms") == 0) {
+            options->algorithm_count = 0;
+            const char *c = value;
+            while (*c != '\0') {
+                char *end;
+                long algorithm = strtol(c, &end, 10);
+                if (end == c || algorithm < 1 || algorithm > ALGORITHM_COUNT ||
+                    options->algorithm_count == ALGORITHM_COUNT || (*end != ',' && *end != '\0')) {
+                    return -1;
+                }
+                options->algorithms[options->algorithm_count++] = (int)algorithm;
+                c = *end == ',' ? end + 1 : end;
+            }
+        } else if (strcmp(argv[i - 1], "--quantum") == 0) {
+            options->time_quantum = atoll(value);
+        } else if (strcmp(argv[i - 1], "--min-time") == 0) {
+            options->min_seconds = atof(value);
+        } else {
+            return -1;
+        }
+    }
+    
+    if (!shape_given && options->generator.burst_distribution == BURST_LOGNORMAL) {
+        options->generator.burst_shape = 1.0;
+    }
+    if (options->min_n < 1 || options->max_n < options->min_n || options->time_quantum <= 0 ||
+        options->algorithm_count == 0 || (options->incremental && options->select)) {
+        return -1;
+    }
+    return 0;
+}
+
+// Measures algorithm at every n from --min-n to --max-n
+static void bench_sizes(const BenchOptions *options, int algorithm) {
+    BenchResult previous = { -1, 0, 0, 0, 0 };
+    int previous_n = 0;
+    
+    for (long long n = options->min_n; n <= options->max_n; n *= 10) {
+        BenchResult result = measure_in_child(options, algorithm, (int)n);
+        
+        // Local exponent of time against n: 1 is linear, 2 is quadratic
+        double scaling = NAN;
+        if (result.status == 0 && previous.status == 0 && previous.seconds > 0) {
+            scaling = log(result.seconds / previous.seconds) / log((double)n / previous_n);
+        }
+        print_result(options, algorithm, (int)n, &result, scaling);
+        fflush(stdout);
+        
+        previous = result;
+        previous_n = (int)n;
+    }
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (parse_options(argc, argv, &options) != 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    // Validate the generator once, before any child runs it
+    GeneratorConfig check = options.generator;
+    ProcessList probe;
+    check.n = 1;
+    process_list_init(&probe);
+    if (generate_processes(&check, &probe) != 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    process_list_free(&probe);
+    
+    const GeneratorConfig *g = &options.generator;
+    if (options.csv) {
+        printf("algorithm,n,runs,seconds,ns_per_job,ns_per_dispatch,peak_rss_kb,scaling\n");
+    } else {
+        printf("{\"seed\":%llu,\"load\":%.3f,\"bursts\":\"%s\",\"burst_mean\":%.3f,"
+               "\"burst_shape\":%.3f,\"priorities\":\"%s\",\"levels\":%d,\"quantum\":%lld}\n",
+               g->seed, g->load, g->burst_distribution == BURST_PARETO ? "pareto" : "lognormal",
+               g->burst_mean, g->burst_shape,
+               g->priority_distribution == PRIORITY_UNIFORM ? "uniform" :
+               g->priority_distribution == PRIORITY_ZIPF ? "zipf" : "constant",
+               g->priority_levels, options.time_quantum);
+    }
+    
+    for (int a = 0; a < options.algorithm_count; a++) {
+        int algorithm = options.algorithms[a];
+        if (options.incremental && !incremental_supports(algorithm)) {
+            continue;
+        }
+        if (!options.select) {
+            bench_sizes(&options, algorithm);
+            continue;
+        }
+        if (!select_supports(algorithm)) {
+            continue;
+        }
+        for (int isa = SELECT_SCALAR; isa <= SELECT_AVX2; isa++) {
+            if (select_isa_supported(isa)) {
+                options.isa = isa;
+                bench_sizes(&options, algorithm);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Checks of the library's error paths: entry points given input they cannot
+// run must return their error code, not hang or produce results. Every
+// check runs under an alarm, so a hang fails instead of blocking make check.
+//
+// Prints one line per failed check and exits with 1 if any failed.
+
+#include "libscheduler.h"
+#include <stdio.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+static void expect(int got, int want, const char *what) {
+    if (got != want) {
+        printf("FAIL %s: got %d, want %d\n", what, got, want);
+        failures++;
+    }
+}
+
+// One process, with columns built by hand the way a caller mapping its own
+// data would, so nothing has validated them
+typedef struct {
+    int pid;
+    long long arrival_time;
+    long long burst_time;
+    int priority;
+    Workload workload;
+} OneProcess;
+
+static Workload *one_process(OneProcess *p, long long arrival_time, long long burst_time) {
+    memset(p, 0, sizeof(OneProcess));
+    p->pid = 1;
+    p->arrival_time = arrival_time;
+    p->burst_time = burst_time;
+    p->workload.n = 1;
+    p->workload.pid = &p->pid;
+    p->workload.arrival_time = &p->arrival_time;
+    p->workload.burst_time = &p->burst_time;
+    p->workload.priority = &p->priority;
+    return &p->workload;
+}
+
+static void check_smp(void) {
+    static const int algorithms[] = { ALGORITHM_FCFS, ALGORITHM_SRJF, ALGORITHM_ROUND_ROBIN };
+    SmpConfig config = { 2, SMP_GLOBAL, 0, 10, { 0, 0 } };
+    RunState state;
+    run_state_init(&state, 1);
+    
+    for (int a = 0; a < 3; a++) {
+        OneProcess p;
+        SmpStats stats;
+        expect(smp_run(algorithms[a], one_process(&p, 0, -3), &state, &config, &stats), SMP_ERR_WORKLOAD,
+               "smp_run with a negative burst");
+        smp_stats_free(&stats);
+        expect(smp_run(algorithms[a], one_process(&p, -5, 3), &state, &config, &stats), SMP_ERR_WORKLOAD,
+               "smp_run with a negative arrival");
+        smp_stats_free(&stats);
+        expect(smp_run(algorithms[a], one_process(&p, 0, 3), &state, &config, &stats), SMP_OK,
+               "smp_run with a valid process");
+        smp_stats_free(&stats);
+        free(p.workload.arrival_order);
+    }
+    run_state_free(&state);
+}
+
+static void check_single_cpu(void) {
+    RunState state;
+    ScheduleOptions options;
+    MlfqConfig mlfq;
+    int queue[1];
+    int batch[1];
+    run_state_init(&state, 1);
+    schedule_options_init(&options, 10);
+    mlfq_config_init(&mlfq, MLFQ_LEVELS, 10);
+    
+    for (int algorithm = 1; algorithm <= ALGORITHM_COUNT; algorithm++) {
+        OneProcess p;
+        expect(run_schedule_with(algorithm, one_process(&p, 0, -3), &state, &options), SCHEDULE_ERR_WORKLOAD,
+               "run_schedule_with with a negative burst");
+        expect(run_schedule_with(algorithm, one_process(&p, -5, 3), &state, &options), SCHEDULE_ERR_WORKLOAD,
+               "run_schedule_with with a negative arrival");
+    }
+    OneProcess p;
+    expect(round_robin_run_with(one_process(&p, 0, -3), &state, 10, &options.cost, queue, batch),
+           SCHEDULE_ERR_WORKLOAD, "round_robin_run_with with a negative burst");
+    expect(mlfq_run_with(one_process(&p, -5, 3), &state, &mlfq, NULL), MLFQ_ERR_WORKLOAD,
+           "mlfq_run_with with a negative arrival");
+    run_state_free(&state);
+}
+
+static void check_realtime(void) {
+    RtConfig config = { 100, { 0, 0 }, NULL };
+    static const int algorithms[] = { ALGORITHM_EDF, ALGORITHM_RM };
+    
+    for (int a = 0; a < 2; a++) {
+        OneProcess p;
+        RtStats stats;
+        RtAnalysis analysis;
+        expect(rt_run(algorithms[a], one_process(&p, 0, -3), &config, &stats), RT_ERR_WORKLOAD,
+               "rt_run with a negative burst");
+        rt_stats_free(&stats);
+        expect(rt_run(algorithms[a], one_process(&p, -5, 3), &config, &stats), RT_ERR_WORKLOAD,
+               "rt_run with a negative arrival");
+        rt_stats_free(&stats);
+        expect(rt_analyze(algorithms[a], one_process(&p, 0, -3), &analysis), RT_ERR_WORKLOAD,
+               "rt_analyze with a negative burst");
+    }
+}
+
+static void count_completion(void *context, const Process *process) {
+    (void)process;
+    (*(int *)context)++;
+}
+
+static void check_online(void) {
+    static const int algorithms[] = { ALGORITHM_FCFS, ALGORITHM_SRJF, ALGORITHM_ROUND_ROBIN };
+    OnlineScheduler scheduler;
+    
+    for (int a = 0; a < 3; a++) {
+        int completed = 0;
+        Process process;
+        memset(&process, 0, sizeof(Process));
+        expect(online_init(&scheduler, algorithms[a], 10, NULL, count_completion, &completed), ONLINE_OK,
+               "online_init");
+        process.pid = 1;
+        process.burst_time = -3;
+        expect(online_push(&scheduler, &process), ONLINE_ERR_INVALID, "online_push with a negative burst");
+        process.arrival_time = -5;
+        process.burst_time = 3;
+        expect(online_push(&scheduler, &process), ONLINE_ERR_INVALID, "online_push with a negative arrival");
+        process.pid = 2;
+        process.arrival_time = 0;
+        process.burst_time = 4;
+        expect(online_push(&scheduler, &process), ONLINE_OK, "online_push after a rejected process");
+        online_finish(&scheduler);
+        expect(completed, 1, "online completions after a rejected process");
+        online_free(&scheduler);
+    }
+    expect(online_init(&scheduler, ALGORITHM_FCFS, 10, NULL, NULL, NULL), ONLINE_ERR_CONFIG,
+           "online_init without a callback");
+    online_free(&scheduler);
+}
+
+int main(void) {
+    alarm(10);
+    check_smp();
+    check_single_cpu();
+    check_realtime();
+    check_online();
+    if (failures == 0) {
+        printf("All checks passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "compare.h"
+#include "arena.h"
+#include "pool.h"
+#include "workload.h"
+#include <time.h>
+
+typedef struct {
+    const Workload *workload;
+    CompareRun *runs;
+    const SwitchCost *cost;
+} CompareBatch;
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void compare_one(void *context, int worker, int index) {
+    CompareBatch *batch = (CompareBatch *)context;
+    CompareRun *run = &batch->runs[index];
+    RunState state;
+    (void)worker;
+    
+    if (run_state_init(&state, batch->workload->n) != 0) {
+        run->status = SCHEDULE_ERR_MEMORY;
+        return;
+    }
+    
+    ScheduleOptions options;
+    schedule_options_init(&options, run->time_quantum);
+    options.cost = *batch->cost;
+    double start = wall_seconds();
+    run->status = run_schedule_with(run->algorithm, batch->workload, &state, &options);
+    run->seconds = wall_seconds() - start;
+    
+    if (run->status == SCHEDULE_OK) {
+        run->total_time = run_total_time(&state);
+        if (calculate_run_metrics(batch->workload, &state, run->total_time, &run->metrics) != 0) {
+            run->status = SCHEDULE_ERR_MEMORY;
+        }
+    }
+    run_state_free(&state);
+}
+
+double compare_runs(Workload *workload, CompareRun *runs, int count, int threads, const SwitchCost *cost) {
+    // Without the shared index every run would sort the arrivals again
+    workload_index(workload);
+    
+    CompareBatch batch = { workload, runs, cost };
+    double start = wall_seconds();
+    pool_run(threads, count, compare_one, &batch);
+    return wall_seconds() - start;
+}
+
+typedef struct {
+    const Workload *workload;
+    SweepRun *runs;
+    Arena *arenas;              // One per worker
+    const SwitchCost *cost;
+} SweepBatch;
+
+static void sweep_one(void *context, int worker, int index) {
+    SweepBatch *batch = (SweepBatch *)context;
+    SweepRun *run = &batch->runs[index];
+    Arena *arena = &batch->arenas[worker];
+    int n = batch->workload->n;
+    
+    arena_reset(arena);
+    RunState state;
+    long long *remaining = (long long *)arena_alloc(arena, n * sizeof(long long));
+    long long *completion = (long long *)arena_alloc(arena, n * sizeof(long long));
+    long long *response = (long long *)arena_alloc(arena, n * sizeof(long long));
+    int *queue = (int *)arena_alloc(arena, n * sizeof(int));
+    int *ready_batch = (int *)arena_alloc(arena, n * sizeof(int));
+    if (remaining == NULL || completion == NULL || response == NULL || queue == NULL || ready_batch == NULL) {
+        run->status = SCHEDULE_ERR_MEMORY;
+        return;
+    }
+    run_state_bind(&state, n, remaining, completion, response);
+    
+    run->status = round_robin_run_with(batch->workload, &state, run->time_quantum, batch->cost, queue, ready_batch);
+    if (run->status != SCHEDULE_OK) {
+        return;
+    }
+    run->total_time = run_total_time(&state);
+    if (calculate_run_metrics(batch->workload, &state, run->total_time, &run->metrics) != 0) {
+        run->status = SCHEDULE_ERR_MEMORY;
+    }
+}
+
+double sweep_quanta(Workload *workload, SweepRun *runs, int count, int threads, const SwitchCost *cost) {
+    workload_index(workload);
+    if (threads > count) threads = count;
+    if (threads < 1) threads = 1;
+    
+    Arena *arenas = (Arena *)malloc(threads * sizeof(Arena));
+    if (arenas == NULL) {
+        for (int i = 0; i < count; i++) {
+            runs[i].status = SCHEDULE_ERR_MEMORY;
+        }
+        return 0;
+    }
+    for (int w = 0; w < threads; w++) {
+        arena_init(&arenas[w]);
+    }
+    
+    SweepBatch batch = { workload, runs, arenas, cost };
+    double start = wall_seconds();
+    pool_run(threads, count, sweep_one, &batch);
+    double elapsed = wall_seconds() - start;
+    
+    for (int w = 0; w < threads; w++) {
+        arena_free(&arenas[w]);
+    }
+    free(arenas);
+    return elapsed;
+}
+
+int sweep_best(const SweepRun *runs, int count) {
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        if (runs[i].status != 0) continue;
+        if (best == -1 ||
+            runs[i].metrics.avg_waiting_time < runs[best].metrics.avg_waiting_time ||
+            (runs[i].metrics.avg_waiting_time == runs[best].metrics.avg_waiting_time &&
+             runs[i].time_quantum < runs[best].time_quantum)) {
+            best = i;
+        }
+    }
+    return best;
+}
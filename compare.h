@@ -0,0 +1,42 @@
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include "scheduling.h"
+
+// One algorithm run in a comparison
+typedef struct {
+    int algorithm;              // Menu number, see algorithm_name()
+    long long time_quantum;     // Round Robin only
+    Metrics metrics;
+    long long total_time;
+    double seconds;             // Wall-clock time of this run alone
+    int status;                 // SCHEDULE_OK, or a SCHEDULE_ERR_ code
+} CompareRun;
+
+// Runs every entry of runs concurrently on up to threads workers. Each run
+// has its own RunState; the workload is shared read-only, after its arrival
+// index has been built. Every run charges cost at each switch. Returns the
+// wall-clock time of the whole batch.
+double compare_runs(Workload *workload, CompareRun *runs, int count, int threads, const SwitchCost *cost);
+
+// One Round Robin run in a quantum sweep
+typedef struct {
+    long long time_quantum;
+    Metrics metrics;
+    long long total_time;
+    int status;                 // SCHEDULE_OK, or a SCHEDULE_ERR_ code
+} SweepRun;
+
+// Runs Round Robin once per entry of runs (time_quantum filled in by the
+// caller) on up to threads workers. Each worker takes its queues and run
+// state from its own arena, reset between runs, so a long sweep allocates
+// only on a worker's first run. A smaller quantum switches more often, so
+// with a switch cost the sweep shows where that overhead starts to dominate.
+// Returns the wall-clock time of the sweep.
+double sweep_quanta(Workload *workload, SweepRun *runs, int count, int threads, const SwitchCost *cost);
+
+// Index of the run with the lowest average waiting time (the smallest
+// quantum on ties), or -1 if no run succeeded
+int sweep_best(const SweepRun *runs, int count);
+
+#endif
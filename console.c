@@ -0,0 +1,174 @@
+#include "console.h"
+#include "workload.h"
+
+void display_menu(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("   CPU SCHEDULING ALGORITHMS SIMULATOR\n");
+    printf("================================================\n");
+    printf("1. First Come First Serve (FCFS)\n");
+    printf("2. Shortest Job First (SJF)\n");
+    printf("3. Shortest Remaining Job First (SRJF)\n");
+    printf("4. Round Robin (RR)\n");
+    printf("5. Priority Scheduling\n");
+    printf("6. Highest Response Ratio Next (HRRN)\n");
+    printf("7. Longest Job First (LJF)\n");
+    printf("8. Longest Remaining Job First (LRJF)\n");
+    printf("9. Completely Fair Scheduler (CFS)\n");
+    printf("10. Lottery Scheduling\n");
+    printf("11. Stride Scheduling\n");
+    printf("12. Preemptive Priority with Aging\n");
+    printf("13. Earliest Deadline First (EDF)\n");
+    printf("14. Rate Monotonic (RM)\n");
+    printf("15. Multi-Level Feedback Queue (MLFQ)\n");
+    printf("16. Exit\n");
+    printf("================================================\n");
+}
+
+long long read_quantum(void) {
+    long long time_quantum;
+    printf("\nEnter time quantum: ");
+    if (scanf("%lld", &time_quantum) != 1 || time_quantum <= 0) {
+        printf("Invalid time quantum!\n");
+        return 0;
+    }
+    return time_quantum;
+}
+
+void display_summary(const char *label, const LatencySummary *summary) {
+    printf("%-12s %10lld %10lld %10lld %10lld\n", label, summary->p50, summary->p95, summary->p99,
+           summary->max);
+}
+
+void display_metrics(const Metrics *metrics, long long total_time) {
+    printf("\n================================================\n");
+    printf("                   METRICS\n");
+    printf("================================================\n");
+    printf("Average Waiting Time:     %.2f units\n", metrics->avg_waiting_time);
+    printf("Average Turnaround Time:  %.2f units\n", metrics->avg_turnaround_time);
+    printf("Average Response Time:    %.2f units\n", metrics->avg_response_time);
+    printf("Total Execution Time:     %lld units\n", total_time);
+    printf("CPU Utilization:          %.2f %%\n", metrics->cpu_utilization);
+    printf("Idle Time:                %lld units\n", metrics->idle_time);
+    printf("Dispatches:               %lld\n", metrics->counters.dispatches);
+    printf("Preemptions:              %lld\n", metrics->counters.preemptions);
+    printf("Context Switches:         %lld\n", metrics->counters.context_switches);
+    printf("Idle Transitions:         %lld\n", metrics->counters.idle_transitions);
+    if (metrics->counters.overhead_time > 0) {
+        printf("Switch Overhead:          %lld units (%.2f %%)\n", metrics->counters.overhead_time,
+               total_time > 0 ? (double)metrics->counters.overhead_time / total_time * 100 : 0.0);
+    }
+    if (metrics->io_time > 0) {
+        printf("I/O Wait Time:            %lld units (%.2f per process)\n", metrics->io_time, metrics->avg_io_time);
+        printf("I/O Busy Time:            %lld units (%.2f %%)\n", metrics->io_busy_time,
+               total_time > 0 ? (double)metrics->io_busy_time / total_time * 100 : 0.0);
+        printf("CPU/I-O Overlap:          %lld units (%.2f %% of I/O busy time)\n", metrics->io_overlap_time,
+               metrics->io_busy_time > 0 ? (double)metrics->io_overlap_time / metrics->io_busy_time * 100 : 0.0);
+    }
+    printf("\n%-12s %10s %10s %10s %10s\n", "", "p50", "p95", "p99", "max");
+    display_summary("Waiting", &metrics->waiting);
+    display_summary("Turnaround", &metrics->turnaround);
+    display_summary("Response", &metrics->response);
+    printf("================================================\n");
+}
+
+void display_mlfq(const MlfqStats *stats, const MlfqConfig *config) {
+    printf("%-6s %10s %12s %12s %11s %10s %10s\n", "Level", "Quantum", "CPU Time", "Residency",
+           "Dispatches", "Demotions", "Completed");
+    for (int level = 0; level < stats->levels; level++) {
+        const MlfqLevelStats *l = &stats->level[level];
+        printf("%-6d %10lld %12lld %12lld %11lld %10lld %10d\n", level, config->quanta[level], l->run_time, l->residency,
+               l->dispatches, l->demotions, l->completed);
+    }
+    printf("\nDemotions:                %lld\n", stats->demotions);
+    printf("Boosts:                   %lld (%lld processes raised)\n", stats->boosts, stats->boosted);
+    printf("Arrival Preemptions:      %lld\n", stats->preemptions);
+    printf("================================================\n");
+}
+
+// Prompts until the number read is at least minimum. Returns -1 at the end
+// of input or on something that is not a number.
+static int read_time(const char *prompt, long long minimum, long long *value) {
+    printf("  %s: ", prompt);
+    while (scanf("%lld", value) == 1) {
+        if (*value >= minimum) {
+            return 0;
+        }
+        printf("  %s must be at least %lld: ", prompt, minimum);
+    }
+    return -1;
+}
+
+int input_processes(ProcessList *list) {
+    int n;
+    
+    printf("\nEnter number of processes: ");
+    if (scanf("%d", &n) != 1 || n <= 0) {
+        return -1;
+    }
+    if (process_list_reserve(list, n) != 0) {
+        return -1;
+    }
+    
+    for (int i = 0; i < n; i++) {
+        Process *process = process_list_append(list);
+        process->pid = i + 1;
+        printf("\nProcess %d:\n", i + 1);
+        if (read_time("Arrival time", 0, &process->arrival_time) != 0) return -1;
+        if (read_time("Burst time", 1, &process->burst_time) != 0) return -1;
+        printf("  Priority (0=highest): ");
+        if (scanf("%d", &process->priority) != 1) return -1;
+        
+        process->remaining_time = process->burst_time;
+        process->completion_time = 0;
+        process->turnaround_time = 0;
+        process->waiting_time = 0;
+        process->response_time = -1;
+    }
+    return 0;
+}
+
+void display_processes(Process *processes, int n) {
+    printf("\n%-5s %-10s %-10s %-10s %-10s %-15s %-15s\n",
+           "PID", "Arrival", "Burst", "Priority", "Complete", "Turnaround", "Waiting");
+    printf("==========================================================================================\n");
+    
+    for (int i = 0; i < n; i++) {
+        printf("%-5d %-10lld %-10lld %-10d %-10lld %-15lld %-15lld\n",
+               processes[i].pid,
+               processes[i].arrival_time,
+               processes[i].burst_time,
+               processes[i].priority,
+               processes[i].completion_time,
+               processes[i].turnaround_time,
+               processes[i].waiting_time);
+    }
+}
+
+void display_run(const Workload *workload, const RunState *state) {
+    int bursts = workload->bursts != NULL;
+    printf("\n%-5s %-10s %-10s ", "PID", "Arrival", "Burst");
+    if (bursts) {
+        printf("%-10s ", "I/O");
+    }
+    printf("%-10s %-10s %-15s %-15s\n", "Priority", "Complete", "Turnaround", "Waiting");
+    printf("==========================================================================================\n");
+    
+    for (int i = 0; i < workload->n; i++) {
+        long long turnaround_time = state->completion_time[i] - workload->arrival_time[i];
+        long long io_time = workload_io_time(workload, i);
+        printf("%-5d %-10lld %-10lld ", workload->pid[i], workload->arrival_time[i], workload->burst_time[i]);
+        if (bursts) {
+            printf("%-10lld ", io_time);
+        }
+        printf("%-10d %-10lld %-15lld %-15lld\n",
+               workload->priority[i],
+               state->completion_time[i],
+               turnaround_time,
+               turnaround_time - workload->burst_time[i] - io_time);
+    }
+}
+
+int write_stream(void *context, const char *data, size_t size) {
+    return fwrite(data, 1, size, (FILE *)context) == size ? 0 : -1;
+}
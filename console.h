@@ -0,0 +1,35 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "scheduling.h"
+#include "mlfq.h"
+#include <stdio.h>
+
+// Prompts and reports of the interactive program. Everything that touches
+// stdin or stdout lives here and in main.c; the library never does.
+
+void display_menu(void);
+
+// Prompts for a Round Robin time quantum; returns 0 if none was given
+long long read_quantum(void);
+
+// Reads processes from the interactive prompt. Returns 0 on success.
+int input_processes(ProcessList *list);
+
+void display_processes(Process *processes, int n);
+
+// Per-process results of a run. With burst sequences, Burst is the CPU total
+// and an I/O column follows it.
+void display_run(const Workload *workload, const RunState *state);
+
+void display_summary(const char *label, const LatencySummary *summary);
+void display_metrics(const Metrics *metrics, long long total_time);
+
+// Per-level MLFQ counters: where the CPU time went, how long processes sat
+// at each level, and how often they were demoted or boosted
+void display_mlfq(const MlfqStats *stats, const MlfqConfig *config);
+
+// TimelineSink that writes to the FILE * passed as its context
+int write_stream(void *context, const char *data, size_t size);
+
+#endif
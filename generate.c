@@ -0,0 +1,105 @@
+#include "generate.h"
+#include "rng.h"
+#include <math.h>
+
+// Uniform in (0, 1], so logarithms and negative powers stay finite
+static double rng_unit(Rng *rng) {
+    return ((rng_next(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static double rng_normal(Rng *rng) {
+    return sqrt(-2.0 * log(rng_unit(rng))) * cos(6.283185307179586 * rng_unit(rng));
+}
+
+// Rounds a sampled duration to at least one unit, capping absurd tails
+static long long to_time(double value) {
+    if (value < 1.0) return 1;
+    if (value > 1e15) return 1000000000000000LL;
+    return (long long)(value + 0.5);
+}
+
+void generator_defaults(GeneratorConfig *config, int n, unsigned long long seed) {
+    config->n = n;
+    config->seed = seed;
+    config->load = 0.9;
+    config->burst_distribution = BURST_PARETO;
+    config->burst_mean = 20.0;
+    config->burst_shape = 1.5;
+    config->priority_distribution = PRIORITY_UNIFORM;
+    config->priority_levels = 10;
+}
+
+int generate_processes(const GeneratorConfig *config, ProcessList *list) {
+    if (config->n < 0 || config->load <= 0 || config->burst_mean < 1 ||
+        config->priority_levels < 1 ||
+        (config->burst_distribution == BURST_PARETO && config->burst_shape <= 1) ||
+        (config->burst_distribution == BURST_LOGNORMAL && config->burst_shape <= 0) ||
+        process_list_reserve(list, list->count + config->n) != 0) {
+        return -1;
+    }
+    
+    // Cumulative weights for Zipf priorities
+    double *zipf = NULL;
+    if (config->priority_distribution == PRIORITY_ZIPF) {
+        zipf = (double *)malloc(config->priority_levels * sizeof(double));
+        if (zipf == NULL) {
+            return -1;
+        }
+        double sum = 0;
+        for (int k = 0; k < config->priority_levels; k++) {
+            sum += 1.0 / (k + 1);
+            zipf[k] = sum;
+        }
+        for (int k = 0; k < config->priority_levels; k++) {
+            zipf[k] /= sum;
+        }
+    }
+    
+    // Pareto scale and lognormal location that give the requested mean
+    double alpha = config->burst_shape;
+    double pareto_scale = config->burst_mean * (alpha - 1) / alpha;
+    double sigma = config->burst_shape;
+    double mu = log(config->burst_mean) - sigma * sigma / 2;
+    double mean_gap = config->burst_mean / config->load;
+    
+    Rng rng;
+    rng_seed(&rng, config->seed);
+    double clock = 0;
+    int first_pid = list->count + 1;
+    
+    for (int i = 0; i < config->n; i++) {
+        Process *process = process_list_append(list);
+        process->pid = first_pid + i;
+        process->arrival_time = (long long)clock;
+        clock += -mean_gap * log(rng_unit(&rng));
+        
+        if (config->burst_distribution == BURST_PARETO) {
+            process->burst_time = to_time(pareto_scale * pow(rng_unit(&rng), -1.0 / alpha));
+        } else {
+            process->burst_time = to_time(exp(mu + sigma * rng_normal(&rng)));
+        }
+        
+        switch (config->priority_distribution) {
+            case PRIORITY_UNIFORM:
+                process->priority = (int)(rng_next(&rng) % (unsigned long long)config->priority_levels);
+                break;
+            case PRIORITY_ZIPF: {
+                double u = rng_unit(&rng);
+                int level = 0;
+                while (level < config->priority_levels - 1 && zipf[level] < u) {
+                    level++;
+                }
+                process->priority = level;
+                break;
+            }
+            default:
+                process->priority = 0;
+                break;
+        }
+        process->remaining_time = process->burst_time;
+        process->response_time = -1;
+    }
+    
+    free(zipf);
+    return 0;
+}
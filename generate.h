@@ -0,0 +1,36 @@
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include "scheduling.h"
+
+// Synthetic workloads. Arrivals form a Poisson process (exponential gaps),
+// bursts are heavy-tailed and priorities follow a chosen distribution. The
+// same configuration and seed always produce the same workload.
+
+#define BURST_PARETO 0
+#define BURST_LOGNORMAL 1
+
+#define PRIORITY_UNIFORM 0
+#define PRIORITY_ZIPF 1             // Level k with weight 1 / (k + 1)
+#define PRIORITY_CONSTANT 2         // Every process at level 0
+
+typedef struct {
+    int n;
+    unsigned long long seed;
+    double load;                    // Offered load: mean burst / mean gap
+    int burst_distribution;
+    double burst_mean;
+    double burst_shape;             // Pareto alpha (> 1) or lognormal sigma
+    int priority_distribution;
+    int priority_levels;
+} GeneratorConfig;
+
+// Defaults: load 0.9, Pareto bursts with mean 20 and alpha 1.5, ten
+// uniformly used priority levels
+void generator_defaults(GeneratorConfig *config, int n, unsigned long long seed);
+
+// Appends config->n processes to list. Returns 0, or -1 on an invalid
+// configuration or when out of memory.
+int generate_processes(const GeneratorConfig *config, ProcessList *list);
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdlib.h>
+
+// Binary heaps shared by every module.
+//
+// HEAP_DEFINE(name, Type, less) defines name_push() and name_pop() over an
+// array of Type whose length the caller keeps and has room for, smallest
+// first by less(a, b). The functions are static inline and the comparison
+// is a plain function, so every heap is specialized for its element type
+// with no indirect calls. A less that ends in a unique field (an index, a
+// sequence number) makes the order popped independent of the order pushed.
+#define HEAP_DEFINE(name, Type, less) \
+    static inline void name##_push(Type *items, int *size, Type entry) { \
+        int pos = (*size)++; \
+        while (pos > 0) { \
+            int parent = (pos - 1) / 2; \
+            if (!less(entry, items[parent])) break; \
+            items[pos] = items[parent]; \
+            pos = parent; \
+        } \
+        items[pos] = entry; \
+    } \
+    \
+    static inline Type name##_pop(Type *items, int *size) { \
+        Type top = items[0]; \
+        Type last = items[--*size]; \
+        int pos = 0; \
+        while (1) { \
+            int child = 2 * pos + 1; \
+            if (child >= *size) break; \
+            if (child + 1 < *size && less(items[child + 1], items[child])) { \
+                child++; \
+            } \
+            if (!less(items[child], last)) break; \
+            items[pos] = items[child]; \
+            pos = child; \
+        } \
+        if (*size > 0) { \
+            items[pos] = last; \
+        } \
+        return top; \
+    }
+
+// (key, idx) pair ordered lexicographically; used both for sorting and heaps
+typedef struct {
+    long long key;
+    int idx;
+} KeyedIndex;
+
+static inline int keyed_less(KeyedIndex a, KeyedIndex b) {
+    return a.key < b.key || (a.key == b.key && a.idx < b.idx);
+}
+
+HEAP_DEFINE(keyed_heap, KeyedIndex, keyed_less)
+
+// Min-heap of (key, idx) pairs in a caller-sized array. Ties on the key go
+// to the lower index.
+typedef struct {
+    KeyedIndex *items;
+    int size;
+} MinHeap;
+
+static inline void heap_push(MinHeap *heap, long long key, int idx) {
+    KeyedIndex entry = { key, idx };
+    keyed_heap_push(heap->items, &heap->size, entry);
+}
+
+static inline KeyedIndex heap_pop(MinHeap *heap) {
+    return keyed_heap_pop(heap->items, &heap->size);
+}
+
+// qsort() order of ints, ascending
+static inline int compare_int(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Heap of indices 0..n-1 ordered by (key[i], tie[i], i), with each index's
+// position tracked so its entry can be re-sifted after its key changes or
+// removed from the middle. tie may be NULL. With descending set, the largest
+// key comes first; ties still go to the smaller tie, then the lower index.
+// The keys are read in place, so the caller updates key[i] and then calls
+// indexed_update().
+typedef struct {
+    int *heap;
+    int *pos;                       // -1 when the index is not in the heap
+    int size;
+    const long long *key;
+    const long long *tie;
+    int descending;
+} IndexedHeap;
+
+static inline int indexed_before(const IndexedHeap *h, int a, int b) {
+    if (h->key[a] != h->key[b]) return h->descending ? h->key[a] > h->key[b] : h->key[a] < h->key[b];
+    if (h->tie != NULL && h->tie[a] != h->tie[b]) return h->tie[a] < h->tie[b];
+    return a < b;
+}
+
+static inline void indexed_place(IndexedHeap *h, int at, int i) {
+    h->heap[at] = i;
+    h->pos[i] = at;
+}
+
+static inline void indexed_sift_up(IndexedHeap *h, int at) {
+    int i = h->heap[at];
+    while (at > 0 && indexed_before(h, i, h->heap[(at - 1) / 2])) {
+        indexed_place(h, at, h->heap[(at - 1) / 2]);
+        at = (at - 1) / 2;
+    }
+    indexed_place(h, at, i);
+}
+
+static inline void indexed_sift_down(IndexedHeap *h, int at) {
+    int i = h->heap[at];
+    while (1) {
+        int child = 2 * at + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && indexed_before(h, h->heap[child + 1], h->heap[child])) {
+            child++;
+        }
+        if (!indexed_before(h, h->heap[child], i)) break;
+        indexed_place(h, at, h->heap[child]);
+        at = child;
+    }
+    indexed_place(h, at, i);
+}
+
+static inline void indexed_push(IndexedHeap *h, int i) {
+    indexed_place(h, h->size++, i);
+    indexed_sift_up(h, h->size - 1);
+}
+
+// Restores the order after key[i] changed either way
+static inline void indexed_update(IndexedHeap *h, int i) {
+    indexed_sift_up(h, h->pos[i]);
+    indexed_sift_down(h, h->pos[i]);
+}
+
+static inline void indexed_remove(IndexedHeap *h, int i) {
+    int at = h->pos[i];
+    int last = h->heap[--h->size];
+    h->pos[i] = -1;
+    if (at == h->size) {
+        return;
+    }
+    indexed_place(h, at, last);
+    indexed_update(h, last);
+}
+
+// An empty heap with room for indices 0..n-1. Returns 0, or -1 when out of
+// memory; call indexed_free() either way.
+static inline int indexed_init(IndexedHeap *h, int n, const long long *key, const long long *tie) {
+    size_t slots = n > 0 ? n : 1;
+    h->heap = (int *)malloc(slots * sizeof(int));
+    h->pos = (int *)malloc(slots * sizeof(int));
+    h->size = 0;
+    h->key = key;
+    h->tie = tie;
+    h->descending = 0;
+    if (h->heap == NULL || h->pos == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        h->pos[i] = -1;
+    }
+    return 0;
+}
+
+static inline void indexed_free(IndexedHeap *h) {
+    free(h->heap);
+    free(h->pos);
+}
+
+#endif
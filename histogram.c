@@ -0,0 +1,86 @@
+#include "histogram.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SUB_BITS 11
+#define SUB_COUNT (1 << SUB_BITS)
+#define HALF_COUNT (SUB_COUNT / 2)
+
+static int bucket_index(unsigned long long value) {
+    if (value < SUB_COUNT) {
+        return (int)value;
+    }
+    int shift = 63 - __builtin_clzll(value) - SUB_BITS + 1;
+    return shift * HALF_COUNT + (int)(value >> shift);
+}
+
+// Largest value that falls into bucket index
+static unsigned long long bucket_high(int index) {
+    if (index < SUB_COUNT) {
+        return (unsigned long long)index;
+    }
+    int shift = index / HALF_COUNT - 1;
+    unsigned long long mantissa = (unsigned long long)(index - shift * HALF_COUNT);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void histogram_init(Histogram *histogram) {
+    histogram->counts = NULL;
+    histogram->capacity = 0;
+    histogram->total = 0;
+    histogram->max = 0;
+}
+
+void histogram_free(Histogram *histogram) {
+    free(histogram->counts);
+    histogram_init(histogram);
+}
+
+int histogram_record(Histogram *histogram, long long value) {
+    if (value < 0) {
+        value = 0;
+    }
+    int index = bucket_index((unsigned long long)value);
+    
+    if (index >= histogram->capacity) {
+        int capacity = histogram->capacity > 0 ? histogram->capacity : SUB_COUNT;
+        while (capacity <= index) {
+            capacity *= 2;
+        }
+        long long *counts = (long long *)realloc(histogram->counts, capacity * sizeof(long long));
+        if (counts == NULL) {
+            return -1;
+        }
+        memset(counts + histogram->capacity, 0, (capacity - histogram->capacity) * sizeof(long long));
+        histogram->counts = counts;
+        histogram->capacity = capacity;
+    }
+    
+    histogram->counts[index]++;
+    histogram->total++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+    return 0;
+}
+
+long long histogram_percentile(const Histogram *histogram, double percentile) {
+    if (histogram->total == 0) {
+        return 0;
+    }
+    
+    long long rank = (long long)ceil(percentile / 100 * histogram->total);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->total) rank = histogram->total;
+    
+    long long seen = 0;
+    for (int index = 0; index < histogram->capacity; index++) {
+        seen += histogram->counts[index];
+        if (seen >= rank) {
+            unsigned long long high = bucket_high(index);
+            return high < (unsigned long long)histogram->max ? (long long)high : histogram->max;
+        }
+    }
+    return histogram->max;
+}
@@ -0,0 +1,26 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+// Log-linear histogram of non-negative values, laid out like an HDR
+// histogram: values below 2048 get a bucket each, then every power of two is
+// split into 1024 buckets. Any quantile is reported within 0.1% of the true
+// value, from one pass and without keeping the values. The bucket array only
+// grows up to the largest value recorded (at most 512 KB).
+typedef struct {
+    long long *counts;
+    int capacity;               // Buckets allocated
+    long long total;            // Values recorded
+    long long max;
+} Histogram;
+
+void histogram_init(Histogram *histogram);
+void histogram_free(Histogram *histogram);
+
+// Returns 0, or -1 if the bucket array could not grow
+int histogram_record(Histogram *histogram, long long value);
+
+// Smallest recorded value v such that at least percentile% of the values
+// are <= v (up to the bucket width), or 0 if the histogram is empty
+long long histogram_percentile(const Histogram *histogram, double percentile);
+
+#endif
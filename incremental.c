@@ -0,0 +1,637 @@
+#include "incremental.h"
+#include "workload.h"
+
+#define FLAG_EDITED 1
+#define FLAG_READY 2                    // Only while comparing two ready sets
+
+int incremental_supports(int algorithm) {
+    return algorithm == ALGORITHM_FCFS || algorithm == ALGORITHM_SJF || algorithm == ALGORITHM_PRIORITY ||
+           algorithm == ALGORITHM_HRRN || algorithm == ALGORITHM_LJF;
+}
+
+// Points the workload, run state and tournament at the columns, which move
+// when they grow
+static void bind_views(Incremental *inc, int n) {
+    Workload *workload = &inc->workload;
+    workload->n = n;
+    workload->pid = inc->pid;
+    workload->arrival_time = inc->arrival_time;
+    workload->burst_time = inc->burst_time;
+    workload->priority = inc->priority;
+    workload->arrival_order = inc->order;
+    inc->state.n = n;
+    inc->state.remaining_time = inc->remaining_time;
+    inc->state.completion_time = inc->completion_time;
+    inc->state.response_time = inc->response_time;
+    inc->ratios.arrival_time = inc->arrival_time;
+    inc->ratios.burst_time = inc->burst_time;
+}
+
+// Resizes the array that pointer (the address of any object pointer) points
+// to. Returns 0, or -1 when out of memory, leaving the array as it was.
+static int grow(void *pointer, size_t count, size_t size) {
+    void *items;
+    memcpy(&items, pointer, sizeof(void *));
+    items = realloc(items, count * size);
+    if (items == NULL) {
+        return -1;
+    }
+    memcpy(pointer, &items, sizeof(void *));
+    return 0;
+}
+
+// Room for capacity processes. The ready queue must be empty. Returns 0, or
+// -1 when out of memory, with the columns intact.
+static int reserve(Incremental *inc, int capacity) {
+    if (capacity <= inc->capacity) {
+        return 0;
+    }
+    size_t count = capacity;
+    int failed = grow(&inc->pid, count, sizeof(int)) | grow(&inc->arrival_time, count, sizeof(long long)) |
+                 grow(&inc->burst_time, count, sizeof(long long)) | grow(&inc->priority, count, sizeof(int)) |
+                 grow(&inc->remaining_time, count, sizeof(long long)) |
+                 grow(&inc->completion_time, count, sizeof(long long)) |
+                 grow(&inc->response_time, count, sizeof(long long)) | grow(&inc->order, count, sizeof(int)) |
+                 grow(&inc->flags, count, 1);
+    switch (inc->algorithm) {
+        case ALGORITHM_FCFS:
+            failed |= grow(&inc->queue, count, sizeof(int));
+            break;
+        case ALGORITHM_HRRN:
+            failed |= grow(&inc->members, count, sizeof(int)) | grow(&inc->position, count, sizeof(int));
+            break;
+        default:
+            failed |= grow(&inc->heap.items, count, sizeof(KeyedIndex));
+            break;
+    }
+    bind_views(inc, inc->workload.n);
+    if (failed) {
+        return -1;
+    }
+    if (inc->algorithm == ALGORITHM_HRRN && capacity > inc->ratios.size) {
+        RatioTournament ratios;
+        if (ratio_tournament_init(&ratios, capacity, inc->arrival_time, inc->burst_time) != 0) {
+            return -1;
+        }
+        ratio_tournament_free(&inc->ratios);
+        inc->ratios = ratios;
+    }
+    memset(inc->flags + inc->capacity, 0, capacity - inc->capacity);
+    inc->front = 0;
+    inc->capacity = capacity;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Ready queue
+// ---------------------------------------------------------------------------
+
+// SJF, Priority and LJF order the heap as run_schedule_with() does
+static long long ready_key(const Incremental *inc, int i) {
+    switch (inc->algorithm) {
+        case ALGORITHM_SJF: return inc->burst_time[i];
+        case ALGORITHM_PRIORITY: return inc->priority[i];
+        default: return -inc->burst_time[i];
+    }
+}
+
+static int ready_count(const Incremental *inc) {
+    return inc->algorithm == ALGORITHM_FCFS || inc->algorithm == ALGORITHM_HRRN ? inc->size : inc->heap.size;
+}
+
+// The k-th process of the ready set; FCFS lists it in queue order
+static int ready_member(const Incremental *inc, int k) {
+    switch (inc->algorithm) {
+        case ALGORITHM_FCFS: return inc->queue[(inc->front + k) % inc->capacity];
+        case ALGORITHM_HRRN: return inc->members[k];
+        default: return inc->heap.items[k].idx;
+    }
+}
+
+static void ready_push(Incremental *inc, int i) {
+    switch (inc->algorithm) {
+        case ALGORITHM_FCFS:
+            inc->queue[(inc->front + inc->size++) % inc->capacity] = i;
+            break;
+        case ALGORITHM_HRRN:
+            ratio_tournament_insert(&inc->ratios, i);
+            inc->position[i] = inc->size;
+            inc->members[inc->size++] = i;
+            break;
+        default:
+            heap_push(&inc->heap, ready_key(inc, i), i);
+            break;
+    }
+}
+
+static int ready_pop(Incremental *inc, long long now) {
+    int idx;
+    switch (inc->algorithm) {
+        case ALGORITHM_FCFS:
+            idx = inc->queue[inc->front];
+            inc->front = (inc->front + 1) % inc->capacity;
+            inc->size--;
+            return idx;
+        case ALGORITHM_HRRN: {
+            ratio_tournament_advance(&inc->ratios, now);
+            idx = ratio_tournament_best(&inc->ratios);
+            ratio_tournament_remove(&inc->ratios, idx);
+            int last = inc->members[--inc->size];
+            inc->members[inc->position[idx]] = last;
+            inc->position[last] = inc->position[idx];
+            return idx;
+        }
+        default:
+            return heap_pop(&inc->heap).idx;
+    }
+}
+
+static void ready_clear(Incremental *inc) {
+    if (inc->algorithm == ALGORITHM_HRRN) {
+        for (int k = 0; k < inc->size; k++) {
+            ratio_tournament_remove(&inc->ratios, inc->members[k]);
+        }
+    }
+    inc->front = 0;
+    inc->size = 0;
+    inc->heap.size = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Checkpoints
+// ---------------------------------------------------------------------------
+
+// Adds the state to the checkpoints of the run in progress, unless there is
+// no memory for it
+static void save_checkpoint(Incremental *inc, long long now, int admitted, int last_idx,
+                            const RunCounters *counters) {
+    int count = ready_count(inc);
+    if (inc->fresh_count == inc->fresh_capacity) {
+        int capacity = inc->fresh_capacity > 0 ? inc->fresh_capacity * 2 : 64;
+        if (grow(&inc->fresh, capacity, sizeof(IncrementalCheckpoint)) != 0) {
+            return;
+        }
+        inc->fresh_capacity = capacity;
+    }
+    if (inc->pool_used + count > inc->pool_capacity) {
+        size_t capacity = inc->pool_capacity > 0 ? inc->pool_capacity * 2 : 4096;
+        while (capacity < inc->pool_used + count) {
+            capacity *= 2;
+        }
+        if (grow(&inc->pool, capacity, sizeof(int)) != 0) {
+            return;
+        }
+        inc->pool_capacity = capacity;
+    }
+    
+    IncrementalCheckpoint *checkpoint = &inc->fresh[inc->fresh_count++];
+    checkpoint->time = now;
+    checkpoint->admitted = admitted;
+    checkpoint->last_idx = last_idx;
+    checkpoint->counters = *counters;
+    checkpoint->ready = inc->pool_used;
+    checkpoint->ready_count = count;
+    for (int k = 0; k < count; k++) {
+        inc->pool[inc->pool_used++] = ready_member(inc, k);
+    }
+}
+
+// The run in progress is in the state the previous run saved in checkpoint.
+// Edited jobs are all behind both, so the admitted counts differ by the
+// appended jobs alone, and equal ready sets leave the same jobs to come.
+static int same_state(Incremental *inc, const IncrementalCheckpoint *checkpoint, int admitted, int last_idx) {
+    int count = ready_count(inc);
+    if (checkpoint->admitted + inc->appended != admitted || checkpoint->ready_count != count ||
+        (checkpoint->last_idx == -1) != (last_idx == -1)) {
+        return 0;
+    }
+    for (int k = 0; k < count; k++) {
+        inc->flags[ready_member(inc, k)] |= FLAG_READY;
+    }
+    int same = 1;
+    for (int k = 0; k < count && same; k++) {
+        same = (inc->flags[inc->pool[checkpoint->ready + k]] & FLAG_READY) != 0;
+    }
+    for (int k = 0; k < count; k++) {
+        inc->flags[ready_member(inc, k)] &= ~FLAG_READY;
+    }
+    return same;
+}
+
+static void counters_shift(RunCounters *counters, const RunCounters *plus, const RunCounters *minus) {
+    counters->dispatches += plus->dispatches - minus->dispatches;
+    counters->preemptions += plus->preemptions - minus->preemptions;
+    counters->context_switches += plus->context_switches - minus->context_switches;
+    counters->idle_transitions += plus->idle_transitions - minus->idle_transitions;
+    counters->overhead_time += plus->overhead_time - minus->overhead_time;
+}
+
+// Copies the live snapshots to a pool of their own size once the dead ones
+// left behind by earlier runs outweigh them
+static void compact_pool(Incremental *inc) {
+    size_t live = 0;
+    for (int c = 0; c < inc->checkpoint_count; c++) {
+        live += inc->checkpoints[c].ready_count;
+    }
+    if (inc->pool_used <= 2 * live + 4096) {
+        return;
+    }
+    int *pool = (int *)malloc((live > 0 ? live : 1) * sizeof(int));
+    if (pool == NULL) {
+        return;
+    }
+    size_t used = 0;
+    for (int c = 0; c < inc->checkpoint_count; c++) {
+        IncrementalCheckpoint *checkpoint = &inc->checkpoints[c];
+        memcpy(pool + used, inc->pool + checkpoint->ready, checkpoint->ready_count * sizeof(int));
+        checkpoint->ready = used;
+        used += checkpoint->ready_count;
+    }
+    free(inc->pool);
+    inc->pool = pool;
+    inc->pool_used = used;
+    inc->pool_capacity = live > 0 ? live : 1;
+}
+
+// Puts the run's checkpoints after checkpoint from, followed by the previous
+// run's from index tail on when it converged there. Checkpoints that find no
+// memory are dropped from the end.
+static void splice_checkpoints(Incremental *inc, int from, int tail, const RunCounters *shift_plus,
+                               const RunCounters *shift_minus) {
+    int kept = tail < inc->checkpoint_count ? inc->checkpoint_count - tail : 0;
+    int total = from + 1 + inc->fresh_count + kept;
+    if (total > inc->checkpoint_capacity) {
+        if (grow(&inc->checkpoints, total, sizeof(IncrementalCheckpoint)) == 0) {
+            inc->checkpoint_capacity = total;
+        } else {
+            total = inc->checkpoint_capacity;
+            if (from + 1 + inc->fresh_count > total) {
+                inc->fresh_count = total - from - 1;
+            }
+            kept = total - from - 1 - inc->fresh_count;
+        }
+    }
+    
+    IncrementalCheckpoint *kept_at = &inc->checkpoints[from + 1 + inc->fresh_count];
+    memmove(kept_at, &inc->checkpoints[tail], kept * sizeof(IncrementalCheckpoint));
+    if (inc->fresh_count > 0) {
+        memcpy(&inc->checkpoints[from + 1], inc->fresh, inc->fresh_count * sizeof(IncrementalCheckpoint));
+    }
+    for (int c = 0; c < kept; c++) {
+        kept_at[c].admitted += inc->appended;
+        counters_shift(&kept_at[c].counters, shift_plus, shift_minus);
+    }
+    inc->checkpoint_count = from + 1 + inc->fresh_count + kept;
+    inc->fresh_count = 0;
+    compact_pool(inc);
+}
+
+// ---------------------------------------------------------------------------
+// Simulation
+// ---------------------------------------------------------------------------
+
+// Runs from checkpoint from to the end, or until the state matches a later
+// checkpoint of the previous run with every edited job behind both runs:
+// pending edited jobs have yet to run here, and the last one ran in the
+// previous run by edited_done. Decisions follow simulate() in scheduling.c
+// for the same policy without burst sequences.
+static void simulate_from(Incremental *inc, int from, long long edited_done, int pending) {
+    const long long *arrival_time = inc->arrival_time;
+    const long long *burst_time = inc->burst_time;
+    const int *order = inc->order;
+    int n = inc->workload.n;
+    const IncrementalCheckpoint *start = &inc->checkpoints[from];
+    long long now = start->time;
+    int admitted = start->admitted;
+    int last_idx = start->last_idx;
+    int completed = admitted - start->ready_count;
+    RunCounters counters = start->counters;
+    
+    // The tournament is empty, so its clock can be set back
+    inc->ratios.now = now;
+    for (int k = 0; k < start->ready_count; k++) {
+        ready_push(inc, inc->pool[start->ready + k]);
+    }
+    inc->replayed = 0;
+    inc->resumed_at = now;
+    inc->converged_at = -1;
+    inc->fresh_count = 0;
+    
+    int interval = inc->interval > 0 ? inc->interval : 1;
+    int next_old = from + 1;
+    int since = 0;                      // Decisions since the last checkpoint
+    while (completed < n) {
+        while (next_old < inc->checkpoint_count && inc->checkpoints[next_old].time < now) {
+            next_old++;
+        }
+        if (pending == 0 && now >= edited_done && next_old < inc->checkpoint_count &&
+            inc->checkpoints[next_old].time == now &&
+            same_state(inc, &inc->checkpoints[next_old], admitted, last_idx)) {
+            inc->converged_at = now;
+            break;
+        }
+        if (since >= interval && since >= ready_count(inc)) {
+            save_checkpoint(inc, now, admitted, last_idx, &counters);
+            since = 0;
+        }
+    
+        if (inc->algorithm == ALGORITHM_HRRN) {
+            ratio_tournament_advance(&inc->ratios, now);
+        }
+        while (admitted < n && arrival_time[order[admitted]] <= now) {
+            ready_push(inc, order[admitted++]);
+        }
+        int idx;
+        if (ready_count(inc) == 0) {
+            // Nothing ready: the next arrival starts at once
+            if (last_idx != -1) {
+                counters.idle_transitions++;
+            }
+            idx = order[admitted++];
+            now = arrival_time[idx];
+        } else {
+            idx = ready_pop(inc, now);
+        }
+    
+        now += run_counters_dispatch(&counters, &inc->cost, last_idx, 1, idx, 0);
+        last_idx = idx;
+        inc->response_time[idx] = now - arrival_time[idx];
+        now += burst_time[idx];
+        inc->completion_time[idx] = now;
+        completed++;
+        since++;
+        inc->replayed++;
+        if (inc->flags[idx] & FLAG_EDITED) {
+            pending--;
+        }
+    }
+    
+    if (inc->converged_at != -1) {
+        const IncrementalCheckpoint *old = &inc->checkpoints[next_old];
+        RunCounters final = inc->state.counters;
+        counters_shift(&final, &counters, &old->counters);
+        RunCounters plus = counters;
+        RunCounters minus = old->counters;
+        splice_checkpoints(inc, from, next_old, &plus, &minus);
+        inc->state.counters = final;
+    } else {
+        splice_checkpoints(inc, from, inc->checkpoint_count, &counters, &counters);
+        inc->state.counters = counters;
+    }
+    ready_clear(inc);
+}
+
+// ---------------------------------------------------------------------------
+// Arrival order
+// ---------------------------------------------------------------------------
+
+// First of the first length entries of the order at or after (arrival, i)
+static int order_search(const Incremental *inc, int length, long long arrival, int i) {
+    int lo = 0;
+    int hi = length;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        int j = inc->order[mid];
+        if (inc->arrival_time[j] < arrival || (inc->arrival_time[j] == arrival && j < i)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Moves process i to its place for a new arrival time. Only the entries
+// between its old and new places shift.
+static void order_move(Incremental *inc, int i, long long arrival) {
+    int n = inc->workload.n;
+    int from = order_search(inc, n, inc->arrival_time[i], i);
+    int to = order_search(inc, n, arrival, i);
+    inc->arrival_time[i] = arrival;
+    if (to > from) {
+        memmove(&inc->order[from], &inc->order[from + 1], (to - 1 - from) * sizeof(int));
+        inc->order[to - 1] = i;
+    } else {
+        memmove(&inc->order[to + 1], &inc->order[to], (from - to) * sizeof(int));
+        inc->order[to] = i;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+
+int incremental_init(Incremental *inc, int algorithm, const Workload *workload, const ScheduleOptions *options) {
+    int n = workload->n;
+    memset(inc, 0, sizeof(Incremental));
+    inc->algorithm = algorithm;
+    inc->interval = INCREMENTAL_INTERVAL;
+    inc->converged_at = -1;
+    if (!incremental_supports(algorithm)) {
+        return INCREMENTAL_ERR_ALGORITHM;
+    }
+    if (options->cost.context_switch < 0 || options->cost.warmup < 0) {
+        return INCREMENTAL_ERR_CONFIG;
+    }
+    if (workload->bursts != NULL) {
+        return INCREMENTAL_ERR_BURSTS;
+    }
+    inc->cost = options->cost;
+    inc->checkpoints = (IncrementalCheckpoint *)malloc(sizeof(IncrementalCheckpoint));
+    if (inc->checkpoints == NULL || reserve(inc, n > 0 ? n : 1) != 0) {
+        return INCREMENTAL_ERR_MEMORY;
+    }
+    inc->checkpoint_capacity = 1;
+    
+    memcpy(inc->pid, workload->pid, n * sizeof(int));
+    memcpy(inc->arrival_time, workload->arrival_time, n * sizeof(long long));
+    memcpy(inc->burst_time, workload->burst_time, n * sizeof(long long));
+    memcpy(inc->priority, workload->priority, n * sizeof(int));
+    memcpy(inc->remaining_time, workload->burst_time, n * sizeof(long long));
+    bind_views(inc, n);
+    
+    // The workload's own arrival index when it has one
+    if (workload->arrival_order != NULL) {
+        memcpy(inc->order, workload->arrival_order, n * sizeof(int));
+    } else {
+        Workload copy = inc->workload;
+        copy.arrival_order = NULL;
+        if (workload_index(&copy) != WORKLOAD_OK) {
+            return INCREMENTAL_ERR_MEMORY;
+        }
+        memcpy(inc->order, copy.arrival_order, n * sizeof(int));
+        free(copy.arrival_order);
+    }
+    
+    // Checkpoint 0 is the empty start, valid whatever is edited later
+    IncrementalCheckpoint *first = &inc->checkpoints[0];
+    memset(first, 0, sizeof(IncrementalCheckpoint));
+    first->last_idx = -1;
+    inc->checkpoint_count = 1;
+    simulate_from(inc, 0, 0, 0);
+    return INCREMENTAL_OK;
+}
+
+void incremental_free(Incremental *inc) {
+    free(inc->pid);
+    free(inc->arrival_time);
+    free(inc->burst_time);
+    free(inc->priority);
+    free(inc->remaining_time);
+    free(inc->completion_time);
+    free(inc->response_time);
+    free(inc->order);
+    free(inc->flags);
+    free(inc->edits);
+    free(inc->checkpoints);
+    free(inc->pool);
+    free(inc->fresh);
+    free(inc->queue);
+    free(inc->heap.items);
+    free(inc->members);
+    free(inc->position);
+    ratio_tournament_free(&inc->ratios);
+    memset(inc, 0, sizeof(Incremental));
+}
+
+static int check_process(const Process *process) {
+    if (process->bursts != NULL) {
+        return INCREMENTAL_ERR_BURSTS;
+    }
+    if (process->arrival_time < 0 || process->burst_time <= 0) {
+        return INCREMENTAL_ERR_INVALID;
+    }
+    return INCREMENTAL_OK;
+}
+
+// Notes job i as edited, with its arrival and completion from the last run
+static int record_edit(Incremental *inc, int i, long long arrival_time, long long completion_time) {
+    if (inc->flags[i] & FLAG_EDITED) {
+        return INCREMENTAL_OK;
+    }
+    if (inc->edit_count == inc->edit_capacity) {
+        int capacity = inc->edit_capacity > 0 ? inc->edit_capacity * 2 : 16;
+        if (grow(&inc->edits, capacity, sizeof(IncrementalEdit)) != 0) {
+            return INCREMENTAL_ERR_MEMORY;
+        }
+        inc->edit_capacity = capacity;
+    }
+    IncrementalEdit *edit = &inc->edits[inc->edit_count++];
+    edit->index = i;
+    edit->arrival_time = arrival_time;
+    edit->completion_time = completion_time;
+    inc->flags[i] |= FLAG_EDITED;
+    return INCREMENTAL_OK;
+}
+
+int incremental_set(Incremental *inc, int i, const Process *process) {
+    int result = check_process(process);
+    if (result != INCREMENTAL_OK) {
+        return result;
+    }
+    if (i < 0 || i >= inc->workload.n) {
+        return INCREMENTAL_ERR_INVALID;
+    }
+    result = record_edit(inc, i, inc->arrival_time[i], inc->completion_time[i]);
+    if (result != INCREMENTAL_OK) {
+        return result;
+    }
+    
+    if (process->arrival_time != inc->arrival_time[i]) {
+        order_move(inc, i, process->arrival_time);
+    }
+    inc->pid[i] = process->pid;
+    inc->burst_time[i] = process->burst_time;
+    inc->priority[i] = process->priority;
+    inc->remaining_time[i] = process->burst_time;
+    return INCREMENTAL_OK;
+}
+
+int incremental_append(Incremental *inc, const Process *process) {
+    int result = check_process(process);
+    if (result != INCREMENTAL_OK) {
+        return result;
+    }
+    int i = inc->workload.n;
+    if (i == INT_MAX) {
+        return INCREMENTAL_ERR_MEMORY;
+    }
+    if (i == inc->capacity && reserve(inc, i < INT_MAX / 2 ? 2 * i : INT_MAX) != 0) {
+        return INCREMENTAL_ERR_MEMORY;
+    }
+    inc->flags[i] = 0;
+    result = record_edit(inc, i, LLONG_MAX, 0);
+    if (result != INCREMENTAL_OK) {
+        return result;
+    }
+    
+    inc->pid[i] = process->pid;
+    inc->arrival_time[i] = process->arrival_time;
+    inc->burst_time[i] = process->burst_time;
+    inc->priority[i] = process->priority;
+    inc->remaining_time[i] = process->burst_time;
+    inc->completion_time[i] = 0;
+    inc->response_time[i] = -1;
+    int at = order_search(inc, i, process->arrival_time, i);
+    memmove(&inc->order[at + 1], &inc->order[at], (i - at) * sizeof(int));
+    inc->order[at] = i;
+    inc->appended++;
+    bind_views(inc, i + 1);
+    return INCREMENTAL_OK;
+}
+
+void incremental_update(Incremental *inc) {
+    if (inc->edit_count == 0) {
+        inc->replayed = 0;
+        inc->resumed_at = -1;
+        inc->converged_at = -1;
+        return;
+    }
+    
+    // No edited job, old or new, had arrived by the earliest arrival among
+    // them, so every checkpoint before it holds for the edited workload too
+    long long earliest = LLONG_MAX;
+    long long edited_done = 0;
+    for (int e = 0; e < inc->edit_count; e++) {
+        const IncrementalEdit *edit = &inc->edits[e];
+        long long arrival = inc->arrival_time[edit->index];
+        if (edit->arrival_time < arrival) {
+            arrival = edit->arrival_time;
+        }
+        if (arrival < earliest) {
+            earliest = arrival;
+        }
+        if (edit->completion_time > edited_done) {
+            edited_done = edit->completion_time;
+        }
+    }
+    int lo = 0;
+    int hi = inc->checkpoint_count - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (inc->checkpoints[mid].time < earliest) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    
+    simulate_from(inc, lo, edited_done, inc->edit_count);
+    for (int e = 0; e < inc->edit_count; e++) {
+        inc->flags[inc->edits[e].index] = 0;
+    }
+    inc->edit_count = 0;
+    inc->appended = 0;
+}
+
+const char *incremental_error_string(int error) {
+    switch (error) {
+        case INCREMENTAL_OK: return "no error";
+        case INCREMENTAL_ERR_MEMORY: return "out of memory";
+        case INCREMENTAL_ERR_ALGORITHM: return "not a non-preemptive algorithm (FCFS, SJF, Priority, HRRN or LJF)";
+        case INCREMENTAL_ERR_CONFIG: return "negative switch cost";
+        case INCREMENTAL_ERR_INVALID: return "negative arrival, non-positive burst or no such process";
+        case INCREMENTAL_ERR_BURSTS: return "burst sequences are not supported";
+        default: return "unknown error";
+    }
+}
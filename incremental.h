@@ -0,0 +1,126 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "scheduling.h"
+#include "heap.h"
+#include "kinetic.h"
+
+// Incremental re-simulation of the non-preemptive schedules (FCFS, SJF,
+// Priority, HRRN and LJF) for what-if analysis.
+//
+// Between two decisions, such a schedule's whole state is the clock, the
+// ready set, how far the arrivals have been admitted, and the counters. A run
+// saves that state as a checkpoint every INCREMENTAL_INTERVAL decisions, or
+// less often while the ready set is larger than that, so the snapshots
+// together hold O(n) entries.
+//
+// Jobs are changed or appended with incremental_set() and
+// incremental_append(). incremental_update() then resumes from the last
+// checkpoint before the earliest arrival any edit touches, old or new.
+// Each time it reaches a checkpoint of the previous run, it compares
+// states. It stops at the first one whose state matches, once every edited
+// job has run in both runs. From there on the two schedules are the same,
+// so the previous results stand and only the counters are shifted. An edit
+// costs the decisions between its checkpoint and the point where the
+// schedule recovers, not a rerun of the whole workload.
+//
+// The simulation matches run_schedule_with() on the same workload, with
+// switch costs; timelines and burst sequences are not supported.
+
+#define INCREMENTAL_INTERVAL 1024
+
+#define INCREMENTAL_OK 0
+#define INCREMENTAL_ERR_MEMORY -1
+#define INCREMENTAL_ERR_ALGORITHM -2    // Not a non-preemptive algorithm
+#define INCREMENTAL_ERR_CONFIG -3       // Negative switch cost
+#define INCREMENTAL_ERR_INVALID -4      // Negative arrival, non-positive burst, index out of range
+#define INCREMENTAL_ERR_BURSTS -5       // Burst sequences
+
+typedef struct {
+    long long time;             // Clock at a decision, before its arrivals are admitted
+    int admitted;               // Entries of the arrival order admitted so far
+    int last_idx;               // Process that ran last, -1 for none
+    RunCounters counters;
+    size_t ready;               // Offset of the ready set in the snapshot pool
+    int ready_count;
+} IncrementalCheckpoint;
+
+// A job changed or appended since the last run
+typedef struct {
+    int index;
+    long long arrival_time;     // Before the first change, LLONG_MAX for an appended job
+    long long completion_time;  // In the last run, 0 for an appended job
+} IncrementalEdit;
+
+typedef struct {
+    int algorithm;
+    SwitchCost cost;
+    int interval;               // Decisions between checkpoints; may be changed between runs
+    Workload workload;          // Read-only view of the columns below, arrival order included
+    RunState state;             // Results of the last run
+    int capacity;
+
+    // Owned columns, edited in place
+    int *pid;
+    long long *arrival_time;
+    long long *burst_time;
+    int *priority;
+    long long *remaining_time;
+    long long *completion_time;
+    long long *response_time;
+    int *order;                 // By (arrival_time, index), kept up to date across edits
+    unsigned char *flags;       // Per process: edited since the last run, in the ready set
+
+    IncrementalEdit *edits;
+    int edit_count;
+    int edit_capacity;
+    int appended;               // Jobs appended since the last run
+
+    IncrementalCheckpoint *checkpoints;
+    int checkpoint_count;
+    int checkpoint_capacity;
+    int *pool;                  // Ready-set snapshots of the checkpoints
+    size_t pool_used;
+    size_t pool_capacity;
+    IncrementalCheckpoint *fresh;   // Checkpoints of the run in progress
+    int fresh_count;
+    int fresh_capacity;
+
+    // Ready queue, empty between runs
+    int *queue;                 // FCFS: ring buffer of capacity slots
+    int front;
+    int size;
+    MinHeap heap;               // SJF, Priority and LJF
+    RatioTournament ratios;     // HRRN
+    int *members;               // HRRN: the ready set, unordered
+    int *position;              // HRRN: index of each ready process in members
+
+    // The last run
+    long long replayed;         // Decisions simulated
+    long long resumed_at;       // Clock of the checkpoint it started from
+    long long converged_at;     // Clock where it rejoined the previous run, -1 if it ran to the end
+} Incremental;
+
+// 1 when algorithm (a menu number) can run incrementally
+int incremental_supports(int algorithm);
+
+// Copies the workload and runs algorithm on it in full, saving checkpoints.
+// Only options->cost is used. Returns an INCREMENTAL_ code; call
+// incremental_free() either way.
+int incremental_init(Incremental *inc, int algorithm, const Workload *workload, const ScheduleOptions *options);
+void incremental_free(Incremental *inc);
+
+// Changes job i's pid, arrival, burst and priority (deadlines do not matter
+// to these algorithms), or appends a job. Both take effect at the next
+// incremental_update(). Return an INCREMENTAL_ code.
+int incremental_set(Incremental *inc, int i, const Process *process);
+int incremental_append(Incremental *inc, const Process *process);
+
+// Re-simulates after the edits since the last run. The results, in
+// inc->state, are those a full run of inc->workload would give. Cannot fail:
+// a checkpoint that finds no memory is skipped, which only costs speed.
+void incremental_update(Incremental *inc);
+
+const char *incremental_error_string(int error);
+
+#endif
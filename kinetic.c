@@ -0,0 +1,141 @@
+#include "kinetic.h"
+#include <limits.h>
+
+#ifndef __SIZEOF_INT128__
+#error "kinetic.c needs a compiler with 128-bit integers"
+#endif
+
+typedef __int128 wide;
+
+#define NEVER LLONG_MAX
+
+static int ranks_lower(const RatioTournament *tournament, int x, int y) {
+    if (tournament->tie_rank != NULL) {
+        return tournament->tie_rank[x] < tournament->tie_rank[y];
+    }
+    return x < y;
+}
+
+// Process x has a strictly better position than y at time t
+static int ratio_beats(const RatioTournament *tournament, int x, int y, long long t) {
+    const long long *a = tournament->arrival_time;
+    const long long *b = tournament->burst_time;
+    wide lhs = (wide)(t - a[x] + b[x]) * b[y];
+    wide rhs = (wide)(t - a[y] + b[y]) * b[x];
+    return lhs > rhs || (lhs == rhs && ranks_lower(tournament, x, y));
+}
+
+static wide floor_div(wide num, wide den) {
+    wide q = num / den;
+    if (num % den != 0 && num < 0) {
+        q--;
+    }
+    return q;
+}
+
+// First time after now at which loser overtakes winner, or NEVER
+static long long overtake_time(const RatioTournament *tournament, int winner, int loser) {
+    const long long *a = tournament->arrival_time;
+    const long long *b = tournament->burst_time;
+    
+    // loser beats winner once (t + c_l) * b_w - (t + c_w) * b_l = slope * t + k
+    // becomes positive (or zero, when loser has the lower index), c = b - a
+    wide slope = (wide)b[winner] - b[loser];
+    if (slope <= 0) {
+        return NEVER;
+    }
+    wide k = (wide)(b[loser] - a[loser]) * b[winner] - (wide)(b[winner] - a[winner]) * b[loser];
+    wide t = ranks_lower(tournament, loser, winner) ? -floor_div(k, slope) : floor_div(-k, slope) + 1;
+    
+    if (t <= tournament->now) {
+        t = tournament->now + 1;
+    }
+    return t > NEVER ? NEVER : (long long)t;
+}
+
+static void recompute(RatioTournament *tournament, int node) {
+    int x = tournament->winner[2 * node];
+    int y = tournament->winner[2 * node + 1];
+    long long expiry = NEVER;
+    
+    if (x < 0 || y < 0) {
+        tournament->winner[node] = x < 0 ? y : x;
+    } else if (ratio_beats(tournament, x, y, tournament->now)) {
+        tournament->winner[node] = x;
+        expiry = overtake_time(tournament, x, y);
+    } else {
+        tournament->winner[node] = y;
+        expiry = overtake_time(tournament, y, x);
+    }
+    
+    if (tournament->expiry[2 * node] < expiry) expiry = tournament->expiry[2 * node];
+    if (tournament->expiry[2 * node + 1] < expiry) expiry = tournament->expiry[2 * node + 1];
+    tournament->expiry[node] = expiry;
+}
+
+int ratio_tournament_init(RatioTournament *tournament, int capacity,
+                          const long long *arrival_time, const long long *burst_time) {
+    int size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+    
+    tournament->size = size;
+    tournament->winner = (int *)malloc(2 * (size_t)size * sizeof(int));
+    tournament->expiry = (long long *)malloc(2 * (size_t)size * sizeof(long long));
+    tournament->arrival_time = arrival_time;
+    tournament->burst_time = burst_time;
+    tournament->tie_rank = NULL;
+    tournament->now = 0;
+    if (tournament->winner == NULL || tournament->expiry == NULL) {
+        ratio_tournament_free(tournament);
+        return -1;
+    }
+    
+    for (int node = 0; node < 2 * size; node++) {
+        tournament->winner[node] = -1;
+        tournament->expiry[node] = NEVER;
+    }
+    return 0;
+}
+
+void ratio_tournament_free(RatioTournament *tournament) {
+    free(tournament->winner);
+    free(tournament->expiry);
+    tournament->winner = NULL;
+    tournament->expiry = NULL;
+}
+
+static void advance_node(RatioTournament *tournament, int node) {
+    if (tournament->expiry[node] > tournament->now) {
+        return;
+    }
+    advance_node(tournament, 2 * node);
+    advance_node(tournament, 2 * node + 1);
+    recompute(tournament, node);
+}
+
+void ratio_tournament_advance(RatioTournament *tournament, long long now) {
+    tournament->now = now;
+    advance_node(tournament, 1);
+}
+
+static void set_leaf(RatioTournament *tournament, int i, int value) {
+    int node = tournament->size + i;
+    tournament->winner[node] = value;
+    for (node /= 2; node >= 1; node /= 2) {
+        recompute(tournament, node);
+    }
+}
+
+void ratio_tournament_insert(RatioTournament *tournament, int i) {
+    set_leaf(tournament, i, i);
+}
+
+void ratio_tournament_remove(RatioTournament *tournament, int i) {
+    set_leaf(tournament, i, -1);
+}
+
+int ratio_tournament_best(const RatioTournament *tournament) {
+    return tournament->winner[1];
+}
@@ -0,0 +1,38 @@
+#ifndef KINETIC_H
+#define KINETIC_H
+
+#include "scheduling.h"
+
+// Kinetic tournament over HRRN response ratios. The ratio of process i,
+// 1 + (t - arrival[i]) / burst[i], is a line in t, so picking the highest
+// ratio is a maximum query over a changing set of lines. Each internal node
+// keeps the winner of its subtree and the earliest time that winner can
+// change; advancing the clock only revisits nodes whose time has come.
+// Comparisons use exact integer cross-multiplication, ties go to the lower
+// process index (or tie_rank, when set), and the clock must never move
+// backwards.
+typedef struct {
+    int size;                       // Leaves, a power of two
+    int *winner;                    // Per node, -1 when the subtree is empty
+    long long *expiry;              // Per node, first time it must be recomputed
+    const long long *arrival_time;
+    const long long *burst_time;
+    const long long *tie_rank;      // Lower rank wins ties; NULL to use the index
+    long long now;
+} RatioTournament;
+
+// Tournament over processes 0..capacity-1, whose columns are read in place
+int ratio_tournament_init(RatioTournament *tournament, int capacity,
+                          const long long *arrival_time, const long long *burst_time);
+void ratio_tournament_free(RatioTournament *tournament);
+
+// Moves the clock to now and repairs every node whose winner changed
+void ratio_tournament_advance(RatioTournament *tournament, long long now);
+
+void ratio_tournament_insert(RatioTournament *tournament, int i);
+void ratio_tournament_remove(RatioTournament *tournament, int i);
+
+// Process with the highest ratio at the current time, or -1 when empty
+int ratio_tournament_best(const RatioTournament *tournament);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef LIBSCHEDULER_H
+#define LIBSCHEDULER_H
+
+// Everything libscheduler exports. Functions take their state from the
+// caller and report errors by return code, so any number of threads can run
+// simulations at once on their own RunStates over a shared, indexed workload.
+
+#include "scheduling.h"
+#include "workload.h"
+#include "generate.h"
+#include "mlfq.h"
+#include "smp.h"
+#include "realtime.h"
+#include "online.h"
+#include "compare.h"
+#include "timeline.h"
+#include "incremental.h"
+
+#endif
@@ -1,111 +1,667 @@
 #include "scheduling.h"
+#include "compare.h"
+#include "console.h"
+#include "mlfq.h"
+#include "online.h"
+#include "pool.h"
+#include "realtime.h"
+#include "smp.h"
+#include "trace.h"
+#include "workload.h"
 #include <limits.h>
 
-void display_menu() {
-    printf("\n");
-    printf("================================================\n");
-    printf("   CPU SCHEDULING ALGORITHMS SIMULATOR\n");
-    printf("================================================\n");
-    printf("1. First Come First Serve (FCFS)\n");
-    printf("2. Shortest Job First (SJF)\n");
-    printf("3. Shortest Remaining Job First (SRJF)\n");
-    printf("4. Round Robin (RR)\n");
-    printf("5. Priority Scheduling\n");
-    printf("6. Highest Response Ratio Next (HRRN)\n");
-    printf("7. Longest Job First (LJF)\n");
-    printf("8. Longest Remaining Job First (LRJF)\n");
-    printf("9. Exit\n");
-    printf("================================================\n");
+void print_usage(const char *program) {
+    printf("Usage: %s [--trace FILE | --workload FILE] [--convert OUT] [--algorithm N | --compare | --sweep A..B] [--quantum Q] [--cpus M]\n", program);
+    printf("  --trace FILE      Load processes from a trace file (\"-\" for stdin)\n");
+    printf("  --workload FILE   Map a binary workload file\n");
+    printf("  --convert OUT     Write the loaded processes as a binary workload and exit\n");
+    printf("  --algorithm N     Run algorithm N (1-%d) and exit\n", ALGORITHM_COUNT);
+    printf("  --quantum Q       Time quantum for Round Robin, Lottery, Stride and MLFQ (its top level)\n");
+    printf("  --seed S          Lottery random seed (default %d)\n", LOTTERY_SEED);
+    printf("  --aging A         Preemptive Priority: wait per level gained, 0 for none (default %d)\n",
+           AGING_INTERVAL);
+    printf("  --latency L       CFS target latency (default %d)\n", CFS_TARGET_LATENCY);
+    printf("  --granularity G   CFS minimum granularity (default %d)\n", CFS_MIN_GRANULARITY);
+    printf("  --levels L        MLFQ levels, 1-%d (default %d)\n", MLFQ_MAX_LEVELS, MLFQ_LEVELS);
+    printf("  --level-quanta Q1,Q2  MLFQ quantum of each level, which also sets the level count\n");
+    printf("  --boost S         MLFQ: time between boosts to the top level, 0 for none (default %d)\n",
+           MLFQ_BOOST_INTERVAL);
+    printf("  --horizon H       EDF and RM: periodic processes release jobs until H (default: one job each)\n");
+    printf("  --compare         Run all algorithms in parallel and compare them\n");
+    printf("  --quanta Q1,Q2    Round Robin quanta for --compare\n");
+    printf("  --sweep A..B      Run Round Robin for every quantum from A to B in parallel\n");
+    printf("  --threads N       Worker threads for --compare and --sweep (default: all cores)\n");
+    printf("  --online          Schedule the trace while reading it (needs --trace and --algorithm)\n");
+    printf("  --cpus M          Run --algorithm on M CPUs\n");
+    printf("  --balance MODE    Load balancing with --cpus: global, push or steal (default)\n");
+    printf("  --migration-cost C  Time lost by a process that moves to another CPU (default 0)\n");
+    printf("  --switch-cost C   Time lost whenever the CPU changes process (default 0)\n");
+    printf("  --warmup W        Extra time for a process resuming a preempted burst (default 0)\n");
+    printf("  --timeline FILE   Write the run's timeline as Chrome trace JSON, or CSV if FILE ends in .csv\n");
 }
 
-void run_algorithm(int choice, Process *processes, int n) {
-    Process *temp_processes = (Process *)malloc(n * sizeof(Process));
+// Where --timeline writes the segments of each run
+typedef struct {
+    const char *path;
+    Timeline timeline;
+} TimelineOutput;
+
+// Writes the last run's timeline, as CSV when the path ends in ".csv" and as
+// Chrome trace-event JSON otherwise. prefix starts each line of the report.
+void write_timeline(const TimelineOutput *output, const char *prefix) {
+    const Timeline *timeline = &output->timeline;
+    size_t length = strlen(output->path);
+    int csv = length >= 4 && strcmp(output->path + length - 4, ".csv") == 0;
     
-    // Copy processes to temporary array
-    for (int i = 0; i < n; i++) {
-        temp_processes[i] = processes[i];
+    FILE *out = fopen(output->path, "w");
+    int result = -1;
+    if (out != NULL) {
+        result = csv ? timeline_write_csv(timeline, write_stream, out) : timeline_write_chrome(timeline, write_stream, out);
+        if (fclose(out) != 0) {
+            result = -1;
+        }
+    }
+    if (result != 0) {
+        printf("%sCould not write timeline %s\n", prefix, output->path);
+        return;
+    }
+    printf("%sWrote %zu timeline segments to %s%s\n", prefix, timeline->count, output->path,
+           timeline->failed ? " (incomplete: out of memory)" : "");
+}
+
+// Allocates the --timeline buffer, with a track per CPU, when there is one.
+// Returns 0, or -1 when out of memory, which is reported.
+int open_timeline(TimelineOutput *timeline, int cpus) {
+    if (timeline != NULL && timeline_init(&timeline->timeline, cpus) != 0) {
+        timeline_free(&timeline->timeline);
+        printf("Out of memory!\n");
+        return -1;
+    }
+    return 0;
+}
+
+void close_timeline(TimelineOutput *timeline) {
+    if (timeline != NULL) {
+        timeline_free(&timeline->timeline);
+    }
+}
+
+// Prompts for the time quantum when the algorithm needs one and options has
+// none. Returns 0, or -1 when none was given.
+int prompt_quantum(int choice, ScheduleOptions *options) {
+    int quanta_given = choice == ALGORITHM_MLFQ && options->level_quanta != NULL;
+    if (algorithm_uses_quantum(choice) && options->time_quantum == 0 && !quanta_given) {
+        options->time_quantum = read_quantum();
+        if (options->time_quantum == 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Runs one algorithm on the workload and reports it. The arrival index is
+// built on the first run and kept in the workload.
+void run_algorithm(int choice, Workload *workload, const ScheduleOptions *options, TimelineOutput *timeline) {
+    const char *name = algorithm_name(choice);
+    if (name == NULL) {
+        printf("Invalid choice!\n");
+        return;
     }
     
-    int total_time = 0;
-    char algorithm_name[50];
+    RunState state;
+    if (workload_index(workload) != WORKLOAD_OK || run_state_init(&state, workload->n) != 0) {
+        printf("Out of memory!\n");
+        return;
+    }
+    if (timeline != NULL) {
+        state.timeline = &timeline->timeline;
+    }
     
-    switch (choice) {
-        case 1:
-            strcpy(algorithm_name, "First Come First Serve (FCFS)");
-            fcfs(temp_processes, n);
-            break;
-        case 2:
-            strcpy(algorithm_name, "Shortest Job First (SJF)");
-            sjf(temp_processes, n);
-            break;
-        case 3:
-            strcpy(algorithm_name, "Shortest Remaining Job First (SRJF)");
-            srjf(temp_processes, n);
-            break;
-        case 4: {
-            int time_quantum;
-            printf("\nEnter time quantum: ");
-            scanf("%d", &time_quantum);
-            strcpy(algorithm_name, "Round Robin (RR)");
-            round_robin(temp_processes, n, time_quantum);
-            break;
+    long long total_time = 0;
+    MlfqConfig mlfq_config;
+    MlfqStats mlfq;
+    if (choice == ALGORITHM_MLFQ) {
+        mlfq_config_from_options(&mlfq_config, options);
+        int result = mlfq_run_with(workload, &state, &mlfq_config, &mlfq);
+        if (result != MLFQ_OK) {
+            printf("%s: %s\n", name, mlfq_error_string(result));
+            run_state_free(&state);
+            return;
         }
-        case 5:
-            strcpy(algorithm_name, "Priority Scheduling");
-            priority_scheduling(temp_processes, n);
-            break;
-        case 6:
-            strcpy(algorithm_name, "Highest Response Ratio Next (HRRN)");
-            hrrn(temp_processes, n);
-            break;
-        case 7:
-            strcpy(algorithm_name, "Longest Job First (LJF)");
-            ljf(temp_processes, n);
-            break;
-        case 8:
-            strcpy(algorithm_name, "Longest Remaining Job First (LRJF)");
-            lrjf(temp_processes, n);
-            break;
-        default:
-            printf("Invalid choice!\n");
-            free(temp_processes);
+    } else {
+        int result = run_schedule_with(choice, workload, &state, options);
+        if (result != SCHEDULE_OK) {
+            printf("%s: %s\n", name, schedule_error_string(result));
+            run_state_free(&state);
             return;
+        }
     }
     
     // Calculate total time
-    for (int i = 0; i < n; i++) {
-        if (temp_processes[i].completion_time > total_time) {
-            total_time = temp_processes[i].completion_time;
-        }
-    }
+    total_time = run_total_time(&state);
     
     // Display results
     printf("\n================================================\n");
-    printf("  %s\n", algorithm_name);
+    printf("  %s\n", name);
     printf("================================================\n");
-    display_processes(temp_processes, n);
+    display_run(workload, &state);
     
     // Calculate and display metrics
     Metrics metrics;
-    calculate_metrics(temp_processes, n, total_time, &metrics);
+    if (calculate_run_metrics(workload, &state, total_time, &metrics) != 0) {
+        printf("Out of memory!\n");
+        run_state_free(&state);
+        return;
+    }
+    
+    display_metrics(&metrics, total_time);
+    if (choice == ALGORITHM_MLFQ) {
+        display_mlfq(&mlfq, &mlfq_config);
+    }
+    if (timeline != NULL) {
+        write_timeline(timeline, "");
+    }
+    run_state_free(&state);
+}
+
+// Runs EDF or RM with periodic releases up to the horizon and reports
+// deadline misses and schedulability along with the usual metrics, per job
+void run_realtime(int choice, Workload *workload, const RtConfig *config, TimelineOutput *timeline) {
+    RtConfig settings = *config;
+    settings.timeline = timeline != NULL ? &timeline->timeline : NULL;
+    RtStats stats;
+    int result = rt_run(choice, workload, &settings, &stats);
+    if (result != RT_OK) {
+        printf("%s: %s\n", algorithm_name(choice), rt_error_string(result));
+        rt_stats_free(&stats);
+        return;
+    }
     
     printf("\n================================================\n");
-    printf("                   METRICS\n");
+    printf("  %s, horizon %lld\n", algorithm_name(choice), config->horizon);
     printf("================================================\n");
-    printf("Average Waiting Time:     %.2f units\n", metrics.avg_waiting_time);
-    printf("Average Turnaround Time:  %.2f units\n", metrics.avg_turnaround_time);
-    printf("Average Response Time:    %.2f units\n", metrics.avg_response_time);
-    printf("Total Execution Time:     %d units\n", total_time);
+    printf("\n%-5s %-10s %-10s %-10s %-10s %-10s %-15s %-15s\n", "PID", "Arrival", "Burst", "Period",
+           "Deadline", "Jobs", "Missed", "Max Lateness");
+    printf("==========================================================================================\n");
+    for (int i = 0; i < workload->n; i++) {
+        const RtTaskStats *task = &stats.task[i];
+        char lateness[24] = "-";
+        if (task->max_lateness != LLONG_MIN) {
+            snprintf(lateness, sizeof(lateness), "%lld", task->max_lateness);
+        }
+        printf("%-5d %-10lld %-10lld %-10lld %-10lld %-10lld %-15lld %-15s\n", workload->pid[i],
+               workload->arrival_time[i], workload->burst_time[i],
+               workload->deadline != NULL ? workload->period[i] : 0, workload_deadline(workload, i),
+               task->jobs, task->missed, lateness);
+    }
+    display_metrics(&stats.metrics, stats.total_time);
+    
+    printf("                  REAL-TIME\n");
+    printf("================================================\n");
+    printf("Jobs:                     %lld\n", stats.jobs);
+    printf("Deadline Misses:          %lld of %lld (%.2f %%)\n", stats.missed, stats.deadline_jobs,
+           stats.deadline_jobs > 0 ? (double)stats.missed / stats.deadline_jobs * 100 : 0.0);
+    printf("Peak Backlog:             %lld jobs\n", stats.peak_backlog);
+    if (stats.missed > 0) {
+        printf("\n%-12s %10s %10s %10s %10s\n", "", "p50", "p95", "p99", "max");
+        display_summary("Lateness", &stats.lateness);
+    }
+    
+    RtAnalysis analysis;
+    if (rt_analyze(choice, workload, &analysis) != RT_OK) {
+        printf("Schedulability:           out of memory\n");
+    } else if (analysis.tasks == 0) {
+        printf("Schedulability:           no periodic processes\n");
+    } else {
+        printf("\nPeriodic Tasks:           %d\n", analysis.tasks);
+        printf("Utilization:              %.4f (density %.4f)\n", analysis.utilization, analysis.density);
+        if (choice == ALGORITHM_RM) {
+            printf("Liu and Layland Bound:    %.4f\n", analysis.bound);
+        }
+        printf("Schedulability:           %s (%s)\n", rt_verdict_name(analysis.verdict), analysis.test);
+    }
+    printf("================================================\n");
+    if (timeline != NULL) {
+        write_timeline(timeline, "");
+    }
+    rt_stats_free(&stats);
+}
+
+// Runs one algorithm on config->cpus CPUs and adds per-CPU statistics to
+// the usual report
+void run_smp(int choice, Workload *workload, const SmpConfig *config, TimelineOutput *timeline) {
+    RunState state;
+    SmpStats stats;
+    if (run_state_init(&state, workload->n) != 0) {
+        printf("Out of memory!\n");
+        return;
+    }
+    if (timeline != NULL) {
+        state.timeline = &timeline->timeline;
+    }
+    
+    int result = smp_run(choice, workload, &state, config, &stats);
+    if (result != SMP_OK) {
+        printf("%s on %d CPU%s: %s\n", algorithm_name(choice), config->cpus, config->cpus == 1 ? "" : "s",
+               smp_error_string(result));
+        smp_stats_free(&stats);
+        run_state_free(&state);
+        return;
+    }
+    
+    printf("\n================================================\n");
+    printf("  %s on %d CPU%s (%s balancing)\n", algorithm_name(choice), config->cpus,
+           config->cpus == 1 ? "" : "s", smp_balance_name(config->balance));
     printf("================================================\n");
+    display_run(workload, &state);
+    
+    Metrics metrics;
+    if (calculate_run_metrics(workload, &state, stats.total_time, &metrics) != 0) {
+        printf("Out of memory!\n");
+    } else {
+        // Capacity is cpus * total_time, not total_time
+        long long capacity = stats.total_time * config->cpus;
+        metrics.idle_time = capacity - metrics.busy_time - metrics.counters.overhead_time;
+        metrics.cpu_utilization = capacity > 0 ? (double)metrics.busy_time / capacity * 100 : 0;
+        display_metrics(&metrics, stats.total_time);
+        
+        printf("\n%-5s %12s %8s %11s %11s %11s %11s %10s\n", "CPU", "Busy", "Util %", "Dispatches",
+               "Switches", "Overhead", "Migrations", "Completed");
+        for (int cpu = 0; cpu < stats.cpus; cpu++) {
+            const SmpCpuStats *c = &stats.cpu[cpu];
+            printf("%-5d %12lld %8.2f %11lld %11lld %11lld %11lld %10d\n", cpu, c->busy_time,
+                   stats.total_time > 0 ? (double)c->busy_time / stats.total_time * 100 : 0.0,
+                   c->dispatches, c->context_switches, c->switch_time + c->migration_time, c->migrations,
+                   c->completed);
+        }
+        printf("\nMigrations:               %lld\n", stats.migrations);
+        printf("Load Imbalance:           %.2f %%\n", stats.imbalance);
+        printf("================================================\n");
+    }
+    if (timeline != NULL) {
+        write_timeline(timeline, "");
+    }
+    
+    smp_stats_free(&stats);
+    run_state_free(&state);
+}
+
+// Runs every algorithm at once, Round Robin once per quantum, and prints the
+// metrics side by side
+void run_comparison(Workload *workload, const long long *quanta, int quantum_count, int threads,
+                    const SwitchCost *cost) {
+    int count = 0;
+    for (int algorithm = 1; algorithm <= ALGORITHM_COUNT; algorithm++) {
+        count += algorithm_uses_quantum(algorithm) ? quantum_count : 1;
+    }
+    CompareRun *runs = (CompareRun *)calloc(count, sizeof(CompareRun));
+    if (runs == NULL) {
+        printf("Out of memory!\n");
+        return;
+    }
+    
+    int k = 0;
+    for (int algorithm = 1; algorithm <= ALGORITHM_COUNT; algorithm++) {
+        if (!algorithm_uses_quantum(algorithm)) {
+            runs[k++].algorithm = algorithm;
+            continue;
+        }
+        for (int q = 0; q < quantum_count; q++) {
+            runs[k].algorithm = algorithm;
+            runs[k++].time_quantum = quanta[q];
+        }
+    }
+    
+    double wall = compare_runs(workload, runs, count, threads, cost);
+    
+    printf("\n================================================\n");
+    if (threads > count) threads = count;
+    printf("  Comparison: %d runs on %d thread%s\n", count, threads, threads == 1 ? "" : "s");
+    printf("================================================\n\n");
+    printf("%-36s %12s %12s %15s %13s %12s %8s %10s %10s\n", "Algorithm", "Avg Wait", "P99 Wait",
+           "Avg Turnaround", "Avg Response", "P99 Response", "CPU %", "Switches", "Run (ms)");
+    printf("=========================================================================================================================================\n");
+    
+    double total_seconds = 0;
+    for (int i = 0; i < count; i++) {
+        char name[64];
+        if (algorithm_uses_quantum(runs[i].algorithm)) {
+            snprintf(name, sizeof(name), "%s, q=%lld", algorithm_name(runs[i].algorithm),
+                     runs[i].time_quantum);
+        } else {
+            snprintf(name, sizeof(name), "%s", algorithm_name(runs[i].algorithm));
+        }
+        
+        if (runs[i].status != 0) {
+            printf("%-36s %12s\n", name, schedule_error_string(runs[i].status));
+            continue;
+        }
+        printf("%-36s %12.2f %12lld %15.2f %13.2f %12lld %8.2f %10lld %10.1f\n", name,
+               runs[i].metrics.avg_waiting_time, runs[i].metrics.waiting.p99,
+               runs[i].metrics.avg_turnaround_time, runs[i].metrics.avg_response_time,
+               runs[i].metrics.response.p99, runs[i].metrics.cpu_utilization,
+               runs[i].metrics.counters.context_switches, runs[i].seconds * 1000);
+        total_seconds += runs[i].seconds;
+    }
+    
+    printf("\nWall time: %.1f ms (runs alone: %.1f ms)\n", wall * 1000, total_seconds * 1000);
+    free(runs);
+}
+
+// Runs Round Robin for every quantum in [first, last] and prints the metrics
+// of each run and the best quantum, with the time each lost to switching
+void run_sweep(Workload *workload, long long first, long long last, int threads, const SwitchCost *cost) {
+    int count = (int)(last - first + 1);
+    SweepRun *runs = (SweepRun *)calloc(count, sizeof(SweepRun));
+    if (runs == NULL) {
+        printf("Out of memory!\n");
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        runs[i].time_quantum = first + i;
+    }
+    
+    double wall = sweep_quanta(workload, runs, count, threads, cost);
+    
+    if (threads > count) threads = count;
+    printf("\n================================================\n");
+    printf("  Round Robin sweep: quanta %lld..%lld on %d thread%s\n", first, last, threads,
+           threads == 1 ? "" : "s");
+    printf("================================================\n\n");
+    printf("%-10s %12s %15s %13s %12s %12s %12s\n", "Quantum", "Avg Wait", "Avg Turnaround",
+           "Avg Response", "P99 Response", "Switches", "Overhead");
+    printf("==============================================================================================\n");
+    for (int i = 0; i < count; i++) {
+        if (runs[i].status != 0) {
+            printf("%-10lld %12s\n", runs[i].time_quantum, schedule_error_string(runs[i].status));
+            continue;
+        }
+        printf("%-10lld %12.2f %15.2f %13.2f %12lld %12lld %12lld\n", runs[i].time_quantum,
+               runs[i].metrics.avg_waiting_time, runs[i].metrics.avg_turnaround_time,
+               runs[i].metrics.avg_response_time, runs[i].metrics.response.p99,
+               runs[i].metrics.counters.context_switches, runs[i].metrics.counters.overhead_time);
+    }
     
-    free(temp_processes);
+    int best = sweep_best(runs, count);
+    if (best != -1) {
+        printf("\nBest quantum: %lld (average waiting time %.2f, %lld context switches)\n",
+               runs[best].time_quantum, runs[best].metrics.avg_waiting_time,
+               runs[best].metrics.counters.context_switches);
+    }
+    printf("Wall time: %.1f ms for %d runs\n", wall * 1000, count);
+    free(runs);
 }
 
-int main() {
-    Process processes[MAX_PROCESSES];
-    int n = 0;
+// Parses a quantum range "FIRST..LAST"
+int parse_range(const char *text, long long *first, long long *last) {
+    char *end;
+    *first = strtoll(text, &end, 10);
+    if (end == text || strncmp(end, "..", 2) != 0) {
+        return -1;
+    }
+    text = end + 2;
+    *last = strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || *first <= 0 || *last < *first || *last - *first >= INT_MAX) {
+        return -1;
+    }
+    return 0;
+}
+
+// Parses a comma-separated list of positive quanta into a new array
+int parse_quanta(const char *text, long long **quanta) {
+    int capacity = 1;
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == ',') capacity++;
+    }
+    *quanta = (long long *)malloc(capacity * sizeof(long long));
+    if (*quanta == NULL) {
+        return -1;
+    }
+    
+    int count = 0;
+    const char *cursor = text;
+    while (count < capacity) {
+        char *end;
+        long long value = strtoll(cursor, &end, 10);
+        if (end == cursor || value <= 0 || (*end != ',' && *end != '\0')) {
+            free(*quanta);
+            *quanta = NULL;
+            return -1;
+        }
+        (*quanta)[count++] = value;
+        cursor = end + 1;
+    }
+    return count;
+}
+
+void print_completion(void *context, const Process *process) {
+    (void)context;
+    printf("%d,%lld,%lld,%d,%lld,%lld,%lld,%lld\n", process->pid, process->arrival_time,
+           process->burst_time, process->priority, process->completion_time,
+           process->turnaround_time, process->waiting_time, process->response_time);
+}
+
+const char *push_online(void *context, const Process *process) {
+    int result = online_push((OnlineScheduler *)context, process);
+    if (result == ONLINE_ERR_ORDER || result == ONLINE_ERR_BURSTS) {
+        return online_error_string(result);
+    }
+    return result == ONLINE_OK ? NULL : TRACE_STOP;
+}
+
+// Schedules a trace as it is read and prints one CSV record per completion.
+// The summary lines start with '#', so the output is itself a valid trace
+// comment block.
+int run_online(const char *trace_path, int algorithm, long long time_quantum, const SwitchCost *cost,
+               TimelineOutput *timeline) {
+    OnlineScheduler scheduler;
+    int result = online_init(&scheduler, algorithm, time_quantum, cost, print_completion, NULL);
+    if (result != ONLINE_OK) {
+        printf("%s\n", online_error_string(result));
+        online_free(&scheduler);
+        return 1;
+    }
+    if (timeline != NULL) {
+        scheduler.timeline = &timeline->timeline;
+    }
+    
+    // A live stream wants each record as soon as it exists
+    if (strcmp(trace_path, "-") == 0) {
+        setvbuf(stdout, NULL, _IOLBF, 0);
+    }
+    printf("pid,arrival,burst,priority,completion,turnaround,waiting,response\n");
+    
+    TraceStats stats;
+    result = stream_trace_file(trace_path, push_online, &scheduler, stderr, &stats);
+    online_finish(&scheduler);
+    
+    Metrics metrics;
+    int metrics_result = online_metrics(&scheduler, &metrics);
+    printf("# %s: %d processes, %d rejected, peak %d live\n", algorithm_name(algorithm),
+           stats.records, stats.rejected, scheduler.peak_live);
+    if (metrics_result == 0 && stats.records > 0) {
+        printf("# average waiting %.2f, turnaround %.2f, response %.2f\n", metrics.avg_waiting_time,
+               metrics.avg_turnaround_time, metrics.avg_response_time);
+        printf("# p99 waiting %lld, turnaround %lld, response %lld\n", metrics.waiting.p99,
+               metrics.turnaround.p99, metrics.response.p99);
+        printf("# cpu utilization %.2f%%, idle %lld\n", metrics.cpu_utilization, metrics.idle_time);
+        printf("# %lld dispatches, %lld preemptions, %lld context switches, %lld idle transitions, overhead %lld\n",
+               metrics.counters.dispatches, metrics.counters.preemptions, metrics.counters.context_switches,
+               metrics.counters.idle_transitions, metrics.counters.overhead_time);
+    }
+    if (timeline != NULL) {
+        write_timeline(timeline, "# ");
+    }
+    online_free(&scheduler);
+    
+    if (result != 0) {
+        fprintf(stderr, "Could not read trace %s\n", trace_path);
+        return 1;
+    }
+    return 0;
+}
+
+// Loads processes from a trace file or the prompt into workload
+int load_processes(const char *trace_path, Workload *workload) {
+    ProcessList processes;
+    process_list_init(&processes);
+    
+    if (trace_path != NULL) {
+        TraceStats stats;
+        if (load_trace_file(trace_path, &processes, stderr, &stats) != 0) {
+            printf("Could not read trace %s\n", trace_path);
+            process_list_free(&processes);
+            return -1;
+        }
+        printf("\nLoaded %d processes from %s in %.3f s (%.0f records/s, %d lines rejected)\n",
+               stats.records, trace_path, stats.seconds,
+               stats.seconds > 0 ? stats.records / stats.seconds : 0.0, stats.rejected);
+        if (stats.records == 0) {
+            printf("No processes to schedule!\n");
+            process_list_free(&processes);
+            return -1;
+        }
+    } else if (input_processes(&processes) != 0) {
+        printf("Invalid input!\n");
+        process_list_free(&processes);
+        return -1;
+    }
+    
+    int result = workload_from_processes(workload, processes.items, processes.count);
+    process_list_free(&processes);
+    if (result != WORKLOAD_OK) {
+        printf("%s\n", workload_error_string(result));
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Workload workload;
     int choice;
     int has_input = 0;
+    const char *trace_path = NULL;
+    const char *workload_path = NULL;
+    const char *convert_path = NULL;
+    int algorithm = 0;
+    long long time_quantum = 0;
+    int compare = 0;
+    int online = 0;
+    const char *quanta_text = NULL;
+    const char *sweep_text = NULL;
+    long long sweep_first = 0, sweep_last = 0;
+    int threads = pool_default_threads();
+    SmpConfig smp = { 0, SMP_STEAL, 0, 0, { 0, 0 } };
+    RtConfig realtime = { 0, { 0, 0 }, NULL };
+    const char *level_quanta_text = NULL;
+    long long level_quanta[MLFQ_MAX_LEVELS];
+    TimelineOutput output;
+    TimelineOutput *timeline = NULL;
+    ScheduleOptions options;
+    schedule_options_init(&options, 0);
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--workload") == 0 && i + 1 < argc) {
+            workload_path = argv[++i];
+        } else if (strcmp(argv[i], "--convert") == 0 && i + 1 < argc) {
+            convert_path = argv[++i];
+        } else if (strcmp(argv[i], "--algorithm") == 0 && i + 1 < argc) {
+            algorithm = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc) {
+            time_quantum = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            options.target_latency = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--granularity") == 0 && i + 1 < argc) {
+            options.min_granularity = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--aging") == 0 && i + 1 < argc) {
+            options.aging_interval = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) {
+            options.mlfq_levels = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--level-quanta") == 0 && i + 1 < argc) {
+            level_quanta_text = argv[++i];
+        } else if (strcmp(argv[i], "--boost") == 0 && i + 1 < argc) {
+            options.boost_interval = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc) {
+            realtime.horizon = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--online") == 0) {
+            online = 1;
+        } else if (strcmp(argv[i], "--compare") == 0) {
+            compare = 1;
+        } else if (strcmp(argv[i], "--quanta") == 0 && i + 1 < argc) {
+            quanta_text = argv[++i];
+        } else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+            sweep_text = argv[++i];
+            if (parse_range(sweep_text, &sweep_first, &sweep_last) != 0) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            smp.cpus = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--balance") == 0 && i + 1 < argc) {
+            smp.balance = smp_balance_parse(argv[++i]);
+        } else if (strcmp(argv[i], "--migration-cost") == 0 && i + 1 < argc) {
+            smp.migration_cost = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--switch-cost") == 0 && i + 1 < argc) {
+            options.cost.context_switch = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            options.cost.warmup = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--timeline") == 0 && i + 1 < argc) {
+            output.path = argv[++i];
+            timeline = &output;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (algorithm < 0 || algorithm > ALGORITHM_COUNT || time_quantum < 0 || (trace_path && workload_path) ||
+        (compare + (algorithm != 0) + (sweep_text != NULL) > 1) || threads < 1 ||
+        (online && (trace_path == NULL || algorithm == 0)) || smp.cpus < 0 || smp.balance < 0 ||
+        smp.migration_cost < 0 || (smp.cpus > 0 && (algorithm == 0 || online)) || options.min_granularity < 1 || options.aging_interval < 0 ||
+        realtime.horizon < 0 || options.mlfq_levels < 1 || options.mlfq_levels > MLFQ_MAX_LEVELS ||
+        options.boost_interval < 0 || options.target_latency < options.min_granularity ||
+        options.cost.context_switch < 0 || options.cost.warmup < 0 ||
+        (timeline != NULL && (compare || sweep_text != NULL || convert_path != NULL))) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    smp.cost = options.cost;
+    realtime.cost = options.cost;
+    if (level_quanta_text != NULL) {
+        long long *quanta;
+        int count = parse_quanta(level_quanta_text, &quanta);
+        if (count < 1 || count > MLFQ_MAX_LEVELS) {
+            printf("Invalid level quanta: %s\n", level_quanta_text);
+            free(quanta);
+            return 1;
+        }
+        memcpy(level_quanta, quanta, count * sizeof(long long));
+        free(quanta);
+        options.mlfq_levels = count;
+        options.level_quanta = level_quanta;
+    }
+    if (online) {
+        if (algorithm == ALGORITHM_ROUND_ROBIN && time_quantum == 0) {
+            printf("Round Robin online requires --quantum\n");
+            return 1;
+        }
+        if (open_timeline(timeline, 1) != 0) {
+            return 1;
+        }
+        int result = run_online(trace_path, algorithm, time_quantum, &options.cost, timeline);
+        close_timeline(timeline);
+        return result;
+    }
+    if (trace_path != NULL && strcmp(trace_path, "-") == 0 && algorithm == 0 && !compare &&
+        sweep_text == NULL && convert_path == NULL) {
+        printf("Reading the trace from stdin requires --algorithm, --compare or --sweep\n");
+        return 1;
+    }
     
     printf("\n");
     printf("================================================\n");
@@ -113,25 +669,121 @@ int main() {
     printf("================================================\n");
     
     // Get initial processes
-    input_processes(processes, &n);
+    if (workload_path != NULL) {
+        int result = workload_open(&workload, workload_path);
+        if (result != WORKLOAD_OK) {
+            printf("Could not open workload %s: %s\n", workload_path, workload_error_string(result));
+            return 1;
+        }
+        printf("\nMapped %d processes from %s\n", workload.n, workload_path);
+    } else if (load_processes(trace_path, &workload) != 0) {
+        return 1;
+    }
     has_input = 1;
     
+    if (convert_path != NULL) {
+        int result = workload_write(&workload, convert_path);
+        if (result != WORKLOAD_OK) {
+            printf("Could not write %s: %s\n", convert_path, workload_error_string(result));
+        } else {
+            printf("Wrote %d processes to %s\n", workload.n, convert_path);
+        }
+        workload_free(&workload);
+        return result == WORKLOAD_OK ? 0 : 1;
+    }
+    
+    if (sweep_text != NULL) {
+        run_sweep(&workload, sweep_first, sweep_last, threads, &options.cost);
+        workload_free(&workload);
+        return 0;
+    }
+    
+    if (compare) {
+        long long *quanta = &time_quantum;
+        int quantum_count = 1;
+        if (quanta_text != NULL) {
+            quantum_count = parse_quanta(quanta_text, &quanta);
+        } else if (time_quantum == 0) {
+            time_quantum = read_quantum();
+            quantum_count = time_quantum != 0 ? 1 : 0;
+        }
+        
+        if (quantum_count < 0) {
+            printf("Invalid quanta: %s\n", quanta_text);
+        } else {
+            run_comparison(&workload, quanta, quantum_count, threads, &options.cost);
+        }
+        if (quanta != &time_quantum) {
+            free(quanta);
+        }
+        workload_free(&workload);
+        return quantum_count < 0 ? 1 : 0;
+    }
+    
+    if (open_timeline(timeline, smp.cpus > 0 ? smp.cpus : 1) != 0) {
+        workload_free(&workload);
+        return 1;
+    }
+    
+    if (algorithm != 0 && smp.cpus > 0) {
+        smp.time_quantum = time_quantum;
+        if (algorithm == ALGORITHM_ROUND_ROBIN && time_quantum == 0) {
+            smp.time_quantum = read_quantum();
+        }
+        if (algorithm != ALGORITHM_ROUND_ROBIN || smp.time_quantum != 0) {
+            run_smp(algorithm, &workload, &smp, timeline);
+        }
+        close_timeline(timeline);
+        workload_free(&workload);
+        return 0;
+    }
+    
+    // Burst sequences have no real-time mode, so EDF and RM run as usual
+    if ((algorithm == ALGORITHM_EDF || algorithm == ALGORITHM_RM) && workload.bursts == NULL) {
+        run_realtime(algorithm, &workload, &realtime, timeline);
+        close_timeline(timeline);
+        workload_free(&workload);
+        return 0;
+    }
+    
+    if (algorithm != 0) {
+        options.time_quantum = time_quantum;
+        if (prompt_quantum(algorithm, &options) == 0) {
+            run_algorithm(algorithm, &workload, &options, timeline);
+        }
+        close_timeline(timeline);
+        workload_free(&workload);
+        return 0;
+    }
+    
     printf("\n\nInitial Processes:\n");
-    display_processes(processes, n);
+    RunState initial;
+    if (run_state_init(&initial, workload.n) == 0) {
+        run_state_reset(&initial, &workload);
+        display_run(&workload, &initial);
+        run_state_free(&initial);
+    }
     
     while (1) {
         display_menu();
         printf("Enter your choice: ");
-        scanf("%d", &choice);
+        if (scanf("%d", &choice) != 1) {
+            break;
+        }
         
-        if (choice == 9) {
+        if (choice == ALGORITHM_COUNT + 1) {
             printf("\nThank you for using CPU Scheduling Simulator!\n");
             break;
         }
         
-        if (choice >= 1 && choice <= 8) {
+        if ((choice == ALGORITHM_EDF || choice == ALGORITHM_RM) && workload.bursts == NULL) {
+            run_realtime(choice, &workload, &realtime, timeline);
+        } else if (choice >= 1 && choice <= ALGORITHM_COUNT) {
             if (has_input) {
-                run_algorithm(choice, processes, n);
+                options.time_quantum = time_quantum;
+                if (prompt_quantum(choice, &options) == 0) {
+                    run_algorithm(choice, &workload, &options, timeline);
+                }
             } else {
                 printf("Please enter processes first!\n");
             }
@@ -144,5 +796,7 @@ int main() {
         getchar(); // wait for user input
     }
     
+    close_timeline(timeline);
+    workload_free(&workload);
     return 0;
 }
@@ -0,0 +1,356 @@
+#include "mlfq.h"
+#include "arrivals.h"
+#include "workload.h"
+
+// FIFO of process indices in a ring buffer that doubles when full, so the
+// levels together hold O(n) slots however the processes are spread
+typedef struct {
+    int *items;
+    int head;
+    int size;
+    int capacity;                       // A power of two
+} LevelQueue;
+
+typedef struct {
+    const Workload *workload;
+    RunState *state;
+    const MlfqConfig *config;
+    MlfqStats *stats;
+    LevelQueue queue[MLFQ_MAX_LEVELS];
+    unsigned long long nonempty;        // Bit k set when level k has a process
+    unsigned char *level;               // Current level of each process
+    long long *used;                    // Quantum used at the current level
+    long long *since;                   // When the process entered its level, or blocked for I/O
+} Mlfq;
+
+static int level_grow(LevelQueue *q) {
+    int capacity = q->capacity > 0 ? q->capacity * 2 : 16;
+    int *items = (int *)malloc((size_t)capacity * sizeof(int));
+    if (items == NULL) {
+        return -1;
+    }
+    for (int k = 0; k < q->size; k++) {
+        items[k] = q->items[(q->head + k) & (q->capacity - 1)];
+    }
+    free(q->items);
+    q->items = items;
+    q->head = 0;
+    q->capacity = capacity;
+    return 0;
+}
+
+static int level_push_back(LevelQueue *q, int i) {
+    if (q->size == q->capacity && level_grow(q) != 0) {
+        return -1;
+    }
+    q->items[(q->head + q->size++) & (q->capacity - 1)] = i;
+    return 0;
+}
+
+static int level_push_front(LevelQueue *q, int i) {
+    if (q->size == q->capacity && level_grow(q) != 0) {
+        return -1;
+    }
+    q->head = (q->head - 1) & (q->capacity - 1);
+    q->items[q->head] = i;
+    q->size++;
+    return 0;
+}
+
+static int level_pop_front(LevelQueue *q) {
+    int i = q->items[q->head];
+    q->head = (q->head + 1) & (q->capacity - 1);
+    q->size--;
+    return i;
+}
+
+static int enqueue(Mlfq *m, int i, int front) {
+    int level = m->level[i];
+    LevelQueue *q = &m->queue[level];
+    if ((front ? level_push_front(q, i) : level_push_back(q, i)) != 0) {
+        return -1;
+    }
+    m->nonempty |= 1ULL << level;
+    return 0;
+}
+
+// Front of the highest non-empty level; the caller checks m->nonempty
+static int dequeue(Mlfq *m) {
+    int level = __builtin_ctzll(m->nonempty);
+    LevelQueue *q = &m->queue[level];
+    int i = level_pop_front(q);
+    if (q->size == 0) {
+        m->nonempty &= ~(1ULL << level);
+    }
+    return i;
+}
+
+// Moves process i to level, charging the time spent at the old one
+static void change_level(Mlfq *m, int i, int level, long long now) {
+    m->stats->level[m->level[i]].residency += now - m->since[i];
+    m->level[i] = (unsigned char)level;
+    m->since[i] = now;
+    m->used[i] = 0;
+}
+
+// Every queued process returns to level 0 with a fresh quantum. Lower levels
+// join the back of level 0 in level order, keeping their own order.
+static int boost(Mlfq *m, long long now) {
+    if (m->nonempty == 0) {
+        return 0;
+    }
+    LevelQueue *top = &m->queue[0];
+    for (int k = 0; k < top->size; k++) {
+        m->used[top->items[(top->head + k) & (top->capacity - 1)]] = 0;
+    }
+    for (int level = 1; level < m->config->levels; level++) {
+        LevelQueue *q = &m->queue[level];
+        while (q->size > 0) {
+            int i = level_pop_front(q);
+            change_level(m, i, 0, now);
+            if (enqueue(m, i, 0) != 0) {
+                return -1;
+            }
+            m->stats->boosted++;
+        }
+    }
+    m->nonempty &= 1;
+    m->stats->boosts++;
+    return 0;
+}
+
+// A process back from I/O rejoins the back of its level with the quantum it
+// had left there, unless a boost came while it was blocked, which returns it
+// to level 0 as if it had been queued
+static void wake(Mlfq *m, int i, long long blocked, long long now) {
+    long long interval = m->config->boost_interval;
+    if (interval > 0 && ((blocked + interval - 1) / interval) * interval < now) {
+        if (m->level[i] > 0) {
+            m->stats->boosted++;
+        }
+        m->level[i] = 0;
+        m->used[i] = 0;
+    }
+    m->since[i] = now;
+}
+
+// Time moves from decision to decision. A slice ends when the process
+// completes or uses up its quantum, at the next boost, and below level 0 at
+// the next arrival. Arrivals up to the end of a slice are queued before the
+// process that ran it. A process that ends a CPU burst blocks for I/O with
+// the quantum it used kept, dropping a level if that used it up; an I/O
+// wakeup cuts a slice below level 0 like an arrival, but only counts as a
+// preemption when another process runs next.
+static int mlfq_simulate(Mlfq *m, Arrivals *arrivals) {
+    const Workload *workload = m->workload;
+    RunState *state = m->state;
+    MlfqStats *stats = m->stats;
+    long long boost_interval = m->config->boost_interval;
+    int n = workload->n;
+    int completed = 0;
+    int last_idx = -1;
+    int last_ended = 0;
+    int pending = -1;                   // Process to requeue after the arrivals
+    int pending_front = 0;
+    int cut_by_arrival = 0;             // The last slice ended at an arrival
+    long long now = 0;
+    long long next_boost = boost_interval > 0 ? boost_interval : LLONG_MAX;
+    
+    while (completed < n) {
+        int i;
+        while ((i = arrivals_pop(arrivals, now)) != -1) {
+            if (state->response_time[i] == -1) {
+                m->level[i] = 0;
+                m->used[i] = 0;
+                m->since[i] = workload->arrival_time[i];
+            } else {
+                wake(m, i, m->since[i], arrivals->ready_since[i]);
+            }
+            if (enqueue(m, i, 0) != 0) {
+                return -1;
+            }
+        }
+        if (pending != -1 && enqueue(m, pending, pending_front) != 0) {
+            return -1;
+        }
+        pending = -1;
+        if (now >= next_boost) {
+            if (boost(m, now) != 0) {
+                return -1;
+            }
+            next_boost = (now / boost_interval + 1) * boost_interval;
+        }
+    
+        if (m->nonempty == 0) {
+            // Nothing ready: jump to the next arrival
+            if (last_idx != -1) {
+                state->counters.idle_transitions++;
+            }
+            now = arrivals_next(arrivals);
+            if (next_boost < now) {
+                next_boost = ((now - 1) / boost_interval + 1) * boost_interval;
+            }
+            continue;
+        }
+    
+        int idx = dequeue(m);
+        int level = m->level[idx];
+        long long quantum = m->config->quanta[level];
+        long long run_time = quantum - m->used[idx];
+        int cut = 0;                    // Slice ended early by an arrival or a boost
+        if (state->remaining_time[idx] < run_time) {
+            run_time = state->remaining_time[idx];
+        }
+        int cold = state->remaining_time[idx] < arrivals_burst(arrivals, idx);
+        long long start = now + run_counters_dispatch(&state->counters, &m->config->cost, last_idx, last_ended,
+                                                      idx, cold);
+        long long until_arrival = LLONG_MAX;
+        if (level > 0) {
+            until_arrival = arrivals_next(arrivals) - start;
+            until_arrival = until_arrival > 0 ? until_arrival : 0;
+        }
+        long long until_boost = next_boost - start > 0 ? next_boost - start : 0;
+        if (cut_by_arrival && idx != last_idx) {
+            stats->preemptions++;
+        }
+        cut_by_arrival = 0;
+        if (until_boost < run_time && until_boost <= until_arrival) {
+            run_time = until_boost;
+            cut = 1;
+        } else if (until_arrival < run_time) {
+            run_time = until_arrival;
+            cut = 1;
+            cut_by_arrival = 1;
+        }
+    
+        last_idx = idx;
+        if (state->response_time[idx] == -1 && run_time > 0) {
+            state->response_time[idx] = start - workload->arrival_time[idx];
+        }
+        stats->level[level].dispatches++;
+        stats->level[level].run_time += run_time;
+    
+        if (state->timeline != NULL) {
+            timeline_record(state->timeline, workload->pid[idx], 0, start, start + run_time);
+        }
+        now = start + run_time;
+        state->remaining_time[idx] -= run_time;
+        m->used[idx] += run_time;
+        last_ended = state->remaining_time[idx] == 0;
+    
+        if (state->remaining_time[idx] == 0) {
+            stats->level[level].residency += now - m->since[idx];
+            if (arrivals_finish(arrivals, idx, now)) {
+                stats->level[level].completed++;
+                completed++;
+            } else {
+                if (m->used[idx] == quantum) {
+                    if (level + 1 < m->config->levels) {
+                        m->level[idx] = (unsigned char)(level + 1);
+                        stats->level[level].demotions++;
+                        stats->demotions++;
+                    }
+                    m->used[idx] = 0;
+                }
+                m->since[idx] = now;
+            }
+        } else if (m->used[idx] == quantum) {
+            if (level + 1 < m->config->levels) {
+                change_level(m, idx, level + 1, now);
+                stats->level[level].demotions++;
+                stats->demotions++;
+            }
+            m->used[idx] = 0;
+            pending = idx;
+            pending_front = 0;
+        } else {
+            pending = idx;
+            pending_front = cut;
+        }
+    }
+    return 0;
+}
+
+void mlfq_config_init(MlfqConfig *config, int levels, long long time_quantum) {
+    memset(config, 0, sizeof(MlfqConfig));
+    config->levels = levels;
+    config->boost_interval = MLFQ_BOOST_INTERVAL;
+    long long quantum = time_quantum;
+    for (int level = 0; level < levels && level < MLFQ_MAX_LEVELS; level++) {
+        config->quanta[level] = quantum;
+        quantum = quantum > LLONG_MAX / 2 ? LLONG_MAX : quantum * 2;
+    }
+}
+
+void mlfq_config_from_options(MlfqConfig *config, const ScheduleOptions *options) {
+    mlfq_config_init(config, options->mlfq_levels, options->time_quantum);
+    config->boost_interval = options->boost_interval;
+    config->cost = options->cost;
+    for (int level = 0; options->level_quanta != NULL && level < options->mlfq_levels &&
+         level < MLFQ_MAX_LEVELS; level++) {
+        config->quanta[level] = options->level_quanta[level];
+    }
+}
+
+int mlfq_run_with(const Workload *workload, RunState *state, const MlfqConfig *config, MlfqStats *stats) {
+    int n = workload->n;
+    MlfqStats scratch;
+    if (stats == NULL) {
+        stats = &scratch;
+    }
+    memset(stats, 0, sizeof(MlfqStats));
+    run_state_reset(state, workload);
+    
+    if (config->levels < 1 || config->levels > MLFQ_MAX_LEVELS || config->boost_interval < 0 ||
+        config->cost.context_switch < 0 || config->cost.warmup < 0) {
+        return MLFQ_ERR_CONFIG;
+    }
+    for (int level = 0; level < config->levels; level++) {
+        if (config->quanta[level] <= 0) {
+            return MLFQ_ERR_CONFIG;
+        }
+    }
+    if (workload_check(workload) != WORKLOAD_OK) {
+        return MLFQ_ERR_WORKLOAD;
+    }
+    stats->levels = config->levels;
+    
+    Mlfq m;
+    memset(&m, 0, sizeof(Mlfq));
+    m.workload = workload;
+    m.state = state;
+    m.config = config;
+    m.stats = stats;
+    m.level = (unsigned char *)malloc(n > 0 ? n : 1);
+    m.used = (long long *)malloc((n > 0 ? n : 1) * sizeof(long long));
+    m.since = (long long *)malloc((n > 0 ? n : 1) * sizeof(long long));
+    
+    Arrivals arrivals;
+    int result = MLFQ_ERR_MEMORY;
+    if (arrivals_init(&arrivals, workload, state) == 0 && m.level != NULL && m.used != NULL && m.since != NULL) {
+        if (mlfq_simulate(&m, &arrivals) == 0) {
+            result = MLFQ_OK;
+        } else {
+            run_state_reset(state, workload);
+        }
+    }
+    
+    arrivals_free(&arrivals);
+    for (int level = 0; level < MLFQ_MAX_LEVELS; level++) {
+        free(m.queue[level].items);
+    }
+    free(m.level);
+    free(m.used);
+    free(m.since);
+    return result;
+}
+
+const char *mlfq_error_string(int error) {
+    switch (error) {
+        case MLFQ_OK: return "no error";
+        case MLFQ_ERR_MEMORY: return "out of memory";
+        case MLFQ_ERR_CONFIG: return "invalid level count, quantum, boost interval or switch cost";
+        case MLFQ_ERR_WORKLOAD: return "negative arrival, deadline or period, or non-positive burst";
+        default: return "unknown error";
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef MLFQ_H
+#define MLFQ_H
+
+#include "scheduling.h"
+
+// Multi-level feedback queue. Level 0 is the highest. A new process joins
+// the back of level 0, and the CPU always serves the front of the highest
+// non-empty level, found in O(1) from a bitmap of non-empty levels. A process
+// that uses up its level's quantum, over one or several slices, drops one
+// level; at the lowest level it takes Round Robin turns. An arrival
+// preempts a process running below level 0, which resumes first at its own
+// level. Every boost interval, all processes return to level 0 with a fresh
+// quantum, so long jobs cannot starve. A slice starts after the switch
+// overhead, and a quantum only counts the time the process ran.
+
+#define MLFQ_MAX_LEVELS 64
+
+#define MLFQ_OK 0
+#define MLFQ_ERR_MEMORY -1
+#define MLFQ_ERR_CONFIG -2
+#define MLFQ_ERR_WORKLOAD -3             // Fails workload_check()
+
+typedef struct {
+    int levels;                         // 1..MLFQ_MAX_LEVELS
+    long long quanta[MLFQ_MAX_LEVELS];  // Time a process gets at each level
+    long long boost_interval;           // 0 disables boosts
+    SwitchCost cost;
+} MlfqConfig;
+
+typedef struct {
+    long long run_time;                 // CPU time spent at this level
+    long long residency;                // Time processes spent at this level, queued or running
+    long long dispatches;
+    long long demotions;                // Processes that dropped out of this level
+    int completed;
+} MlfqLevelStats;
+
+typedef struct {
+    int levels;
+    MlfqLevelStats level[MLFQ_MAX_LEVELS];
+    long long demotions;
+    long long boosts;                   // Boosts with at least one process waiting
+    long long boosted;                  // Processes raised to level 0 by boosts
+    long long preemptions;              // Slices below level 0 cut short by an arrival
+} MlfqStats;
+
+// levels levels with quanta doubling from time_quantum, boosts every
+// MLFQ_BOOST_INTERVAL, free switches
+void mlfq_config_init(MlfqConfig *config, int levels, long long time_quantum);
+
+// The levels, quanta, boost interval and switch cost set in options
+void mlfq_config_from_options(MlfqConfig *config, const ScheduleOptions *options);
+
+// Runs the workload; stats may be NULL. Returns an MLFQ_ code:
+// MLFQ_ERR_WORKLOAD for a negative arrival or a burst below 1. On error the
+// state is reset.
+int mlfq_run_with(const Workload *workload, RunState *state, const MlfqConfig *config, MlfqStats *stats);
+
+const char *mlfq_error_string(int error);
+
+#endif
@@ -0,0 +1,309 @@
+#include "online.h"
+#include "heap.h"
+#include <limits.h>
+
+#define ONLINE_MIN_CAPACITY 64
+
+// Runs to completion once dispatched
+static int is_non_preemptive(int algorithm) {
+    return algorithm != ALGORITHM_SRJF && algorithm != ALGORITHM_ROUND_ROBIN;
+}
+
+static long long heap_key(const OnlineScheduler *s, int slot) {
+    switch (s->algorithm) {
+        case ALGORITHM_FCFS: return s->sequence[slot];
+        case ALGORITHM_SJF: return s->burst_time[slot];
+        case ALGORITHM_SRJF: return s->remaining_time[slot];
+        case ALGORITHM_PRIORITY: return s->priority[slot];
+        default: return -s->burst_time[slot];       // LJF
+    }
+}
+
+static int entry_less(OnlineEntry a, OnlineEntry b) {
+    return a.key < b.key || (a.key == b.key && a.sequence < b.sequence);
+}
+
+HEAP_DEFINE(online_heap, OnlineEntry, entry_less)
+
+// Doubles every per-slot array, keeping the queue order and the tournament
+static int grow(OnlineScheduler *s) {
+    int old_capacity = s->capacity;
+    int capacity = old_capacity > 0 ? old_capacity * 2 : ONLINE_MIN_CAPACITY;
+    if (old_capacity > INT_MAX / 2) {
+        return ONLINE_ERR_MEMORY;
+    }
+    
+#define GROW(column, type) do { \
+        type *grown = (type *)realloc(s->column, capacity * sizeof(type)); \
+        if (grown == NULL) return ONLINE_ERR_MEMORY; \
+        s->column = grown; \
+    } while (0)
+    GROW(pid, int);
+    GROW(priority, int);
+    GROW(arrival_time, long long);
+    GROW(burst_time, long long);
+    GROW(remaining_time, long long);
+    GROW(response_time, long long);
+    GROW(sequence, long long);
+    GROW(free_slots, int);
+    GROW(heap, OnlineEntry);
+#undef GROW
+    
+    int *queue = (int *)malloc(capacity * sizeof(int));
+    if (queue == NULL) {
+        return ONLINE_ERR_MEMORY;
+    }
+    for (int k = 0; k < s->queue_size; k++) {
+        queue[k] = s->queue[(s->queue_front + k) % old_capacity];
+    }
+    free(s->queue);
+    s->queue = queue;
+    s->queue_front = 0;
+    
+    // New slots are free; hand them out lowest first
+    for (int slot = capacity - 1; slot >= old_capacity; slot--) {
+        s->sequence[slot] = -1;
+        s->free_slots[s->free_count++] = slot;
+    }
+    s->capacity = capacity;
+    
+    if (s->algorithm == ALGORITHM_HRRN) {
+        // The tournament reads the columns in place, so rebuild it over the
+        // moved columns with every live (that is, ready) process
+        RatioTournament ratios;
+        if (ratio_tournament_init(&ratios, capacity, s->arrival_time, s->burst_time) != 0) {
+            return ONLINE_ERR_MEMORY;
+        }
+        ratios.tie_rank = s->sequence;
+        ratio_tournament_advance(&ratios, s->now);
+        for (int slot = 0; slot < old_capacity; slot++) {
+            if (s->sequence[slot] != -1) {
+                ratio_tournament_insert(&ratios, slot);
+            }
+        }
+        ratio_tournament_free(&s->ratios);
+        s->ratios = ratios;
+    }
+    return ONLINE_OK;
+}
+
+static void make_ready(OnlineScheduler *s, int slot) {
+    if (s->algorithm == ALGORITHM_ROUND_ROBIN) {
+        s->queue[(s->queue_front + s->queue_size++) % s->capacity] = slot;
+    } else if (s->algorithm == ALGORITHM_HRRN) {
+        ratio_tournament_advance(&s->ratios, s->now);
+        ratio_tournament_insert(&s->ratios, slot);
+        s->ready_ratios++;
+    } else {
+        OnlineEntry entry = { heap_key(s, slot), s->sequence[slot], slot };
+        online_heap_push(s->heap, &s->heap_size, entry);
+    }
+}
+
+static int ready_count(const OnlineScheduler *s) {
+    if (s->algorithm == ALGORITHM_ROUND_ROBIN) return s->queue_size;
+    if (s->algorithm == ALGORITHM_HRRN) return s->ready_ratios;
+    return s->heap_size;
+}
+
+// Removes the ready process that the policy runs next at time now
+static int take_next(OnlineScheduler *s) {
+    if (s->algorithm == ALGORITHM_ROUND_ROBIN) {
+        int slot = s->queue[s->queue_front];
+        s->queue_front = (s->queue_front + 1) % s->capacity;
+        s->queue_size--;
+        return slot;
+    }
+    if (s->algorithm == ALGORITHM_HRRN) {
+        ratio_tournament_advance(&s->ratios, s->now);
+        int slot = ratio_tournament_best(&s->ratios);
+        ratio_tournament_remove(&s->ratios, slot);
+        s->ready_ratios--;
+        return slot;
+    }
+    return online_heap_pop(s->heap, &s->heap_size).slot;
+}
+
+static void complete(OnlineScheduler *s, int slot) {
+    Process process;
+    process.pid = s->pid[slot];
+    process.arrival_time = s->arrival_time[slot];
+    process.burst_time = s->burst_time[slot];
+    process.remaining_time = 0;
+    process.priority = s->priority[slot];
+    process.completion_time = s->now;
+    process.turnaround_time = s->now - process.arrival_time;
+    process.waiting_time = process.turnaround_time - process.burst_time;
+    process.response_time = s->response_time[slot];
+    
+    metrics_accumulator_add(&s->metrics, process.turnaround_time, process.burst_time, 0,
+                            process.response_time);
+    s->last_completion = s->now;
+    s->last_slot = ONLINE_COMPLETED;
+    s->sequence[slot] = -1;
+    s->free_slots[s->free_count++] = slot;
+    s->live--;
+    s->on_complete(s->context, &process);
+}
+
+// Gives slot the CPU at time now for up to run_time units, after the switch
+// overhead, and never past limit
+static void run(OnlineScheduler *s, int slot, long long run_time, long long limit) {
+    int cold = s->remaining_time[slot] < s->burst_time[slot];
+    s->now += run_counters_dispatch(&s->counters, &s->cost, s->last_slot, s->last_ended, slot, cold);
+    s->last_slot = slot;
+    if (run_time > s->remaining_time[slot]) {
+        run_time = s->remaining_time[slot];
+    }
+    if (run_time > limit - s->now) {
+        run_time = limit > s->now ? limit - s->now : 0;
+    }
+    if (s->response_time[slot] == -1 && run_time > 0) {
+        s->response_time[slot] = s->now - s->arrival_time[slot];
+    }
+    if (s->timeline != NULL) {
+        timeline_record(s->timeline, s->pid[slot], 0, s->now, s->now + run_time);
+    }
+    s->remaining_time[slot] -= run_time;
+    s->now += run_time;
+    s->last_ended = s->remaining_time[slot] == 0;
+    
+    if (s->remaining_time[slot] == 0) {
+        complete(s, slot);
+    } else {
+        make_ready(s, slot);
+    }
+}
+
+// Makes every scheduling decision due before limit. Decisions at limit wait,
+// since more processes may still arrive then.
+static void advance(OnlineScheduler *s, long long limit) {
+    while (s->now < limit && ready_count(s) > 0) {
+        int slot = take_next(s);
+        if (s->algorithm == ALGORITHM_ROUND_ROBIN) {
+            run(s, slot, s->time_quantum, LLONG_MAX);
+        } else if (is_non_preemptive(s->algorithm)) {
+            run(s, slot, s->remaining_time[slot], LLONG_MAX);
+        } else {
+            // SRJF runs until it completes or the next arrival
+            run(s, slot, s->remaining_time[slot], limit);
+        }
+    }
+}
+
+int online_init(OnlineScheduler *scheduler, int algorithm, long long time_quantum, const SwitchCost *cost,
+                CompletionFn on_complete, void *context) {
+    memset(scheduler, 0, sizeof(OnlineScheduler));
+    // Every algorithm after LJF is batch only
+    if (algorithm < 1 || algorithm > ALGORITHM_LJF ||
+        (algorithm == ALGORITHM_ROUND_ROBIN && time_quantum <= 0)) {
+        return ONLINE_ERR_UNSUPPORTED;
+    }
+    if (on_complete == NULL || (cost != NULL && (cost->context_switch < 0 || cost->warmup < 0))) {
+        return ONLINE_ERR_CONFIG;
+    }
+    scheduler->algorithm = algorithm;
+    scheduler->time_quantum = time_quantum;
+    if (cost != NULL) {
+        scheduler->cost = *cost;
+    }
+    scheduler->last_slot = -1;
+    scheduler->on_complete = on_complete;
+    scheduler->context = context;
+    metrics_accumulator_init(&scheduler->metrics);
+    if (algorithm == ALGORITHM_HRRN && ratio_tournament_init(&scheduler->ratios, 1, NULL, NULL) != 0) {
+        return ONLINE_ERR_MEMORY;
+    }
+    return ONLINE_OK;
+}
+
+int online_push(OnlineScheduler *scheduler, const Process *process) {
+    OnlineScheduler *s = scheduler;
+    if (process->arrival_time < 0 || process->burst_time <= 0) {
+        return ONLINE_ERR_INVALID;
+    }
+    if (process->arrival_time < s->last_arrival) {
+        return ONLINE_ERR_ORDER;
+    }
+    if (process->bursts != NULL) {
+        return ONLINE_ERR_BURSTS;
+    }
+    s->last_arrival = process->arrival_time;
+    advance(s, process->arrival_time);
+    
+    if (s->free_count == 0 && grow(s) != ONLINE_OK) {
+        return ONLINE_ERR_MEMORY;
+    }
+    int slot = s->free_slots[--s->free_count];
+    s->pid[slot] = process->pid;
+    s->priority[slot] = process->priority;
+    s->arrival_time[slot] = process->arrival_time;
+    s->burst_time[slot] = process->burst_time;
+    s->remaining_time[slot] = process->burst_time;
+    s->response_time[slot] = -1;
+    s->sequence[slot] = s->pushed++;
+    if (++s->live > s->peak_live) {
+        s->peak_live = s->live;
+    }
+    
+    if (s->now < process->arrival_time) {
+        // Idle CPU: like the batch versions, the first arrival starts at once
+        // (SRJF for a single unit) before later ones at the same time are seen
+        if (s->last_slot != -1) {
+            s->counters.idle_transitions++;
+        }
+        s->now = process->arrival_time;
+        if (s->algorithm == ALGORITHM_ROUND_ROBIN) {
+            run(s, slot, s->time_quantum, LLONG_MAX);
+        } else if (is_non_preemptive(s->algorithm)) {
+            run(s, slot, s->remaining_time[slot], LLONG_MAX);
+        } else {
+            run(s, slot, 1, LLONG_MAX);
+        }
+    } else {
+        make_ready(s, slot);
+    }
+    return ONLINE_OK;
+}
+
+int online_finish(OnlineScheduler *scheduler) {
+    advance(scheduler, LLONG_MAX);
+    return ONLINE_OK;
+}
+
+int online_metrics(const OnlineScheduler *scheduler, Metrics *metrics) {
+    int result = metrics_accumulator_summary(&scheduler->metrics, scheduler->last_completion, metrics);
+    metrics_set_counters(metrics, &scheduler->counters);
+    return result;
+}
+
+void online_free(OnlineScheduler *scheduler) {
+    free(scheduler->pid);
+    free(scheduler->priority);
+    free(scheduler->arrival_time);
+    free(scheduler->burst_time);
+    free(scheduler->remaining_time);
+    free(scheduler->response_time);
+    free(scheduler->sequence);
+    free(scheduler->free_slots);
+    free(scheduler->heap);
+    free(scheduler->queue);
+    if (scheduler->algorithm == ALGORITHM_HRRN) {
+        ratio_tournament_free(&scheduler->ratios);
+    }
+    metrics_accumulator_free(&scheduler->metrics);
+    memset(scheduler, 0, sizeof(OnlineScheduler));
+}
+
+const char *online_error_string(int error) {
+    switch (error) {
+        case ONLINE_OK: return "no error";
+        case ONLINE_ERR_MEMORY: return "out of memory";
+        case ONLINE_ERR_ORDER: return "arrival time before the previous record";
+        case ONLINE_ERR_UNSUPPORTED: return "algorithm not available online";
+        case ONLINE_ERR_BURSTS: return "burst sequences are not available online";
+        case ONLINE_ERR_INVALID: return "negative arrival or non-positive burst";
+        case ONLINE_ERR_CONFIG: return "no completion callback, or a negative switch cost";
+        default: return "unknown error";
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include "scheduling.h"
+#include "kinetic.h"
+
+// Online scheduling. Processes are pushed one at a time in arrival order,
+// for example from a pipe, and every completion is reported as soon as no
+// later arrival can change it. Only live processes (pushed and not yet
+// complete) are stored, so memory follows the peak live count rather than the
+// length of the stream. On an arrival-sorted workload the schedule is the
+// same as the batch algorithm's, with push order breaking ties. Algorithms
+// after LJF are not available online: LRJF's batch version groups processes
+// by index, and the others have no streaming version. Switches cost what
+// they do in the batch run.
+
+#define ONLINE_OK 0
+#define ONLINE_ERR_MEMORY -1
+#define ONLINE_ERR_ORDER -2             // Arrival earlier than the previous push
+#define ONLINE_ERR_UNSUPPORTED -3
+#define ONLINE_ERR_BURSTS -4            // A process with a CPU and I/O burst sequence
+#define ONLINE_ERR_INVALID -5           // Negative arrival or non-positive burst
+#define ONLINE_ERR_CONFIG -6            // No completion callback, or a negative switch cost
+
+// last_slot once the process that ran last has completed, since its slot may
+// already hold a new process
+#define ONLINE_COMPLETED -2
+
+// Receives each completed process with all of its result fields filled in
+typedef void (*CompletionFn)(void *context, const Process *process);
+
+typedef struct {
+    long long key;
+    long long sequence;
+    int slot;
+} OnlineEntry;
+
+typedef struct {
+    int algorithm;
+    long long time_quantum;
+    SwitchCost cost;
+    CompletionFn on_complete;
+    void *context;
+    long long now;                      // The CPU is busy until now
+    long long last_arrival;
+    long long pushed;                   // Also the next sequence number
+    long long last_completion;
+    int last_slot;                      // Process that ran last, see ONLINE_COMPLETED
+    int last_ended;
+    RunCounters counters;
+    Timeline *timeline;                 // Set after online_init() to record every run; grows with the stream
+    
+    // Live processes, one slot each, as columns
+    int capacity;
+    int *pid;
+    int *priority;
+    long long *arrival_time;
+    long long *burst_time;
+    long long *remaining_time;
+    long long *response_time;
+    long long *sequence;                // -1 for a free slot
+    int *free_slots;
+    int free_count;
+    int live;
+    int peak_live;
+    
+    // Ready processes: a heap, the Round Robin queue or the HRRN tournament
+    OnlineEntry *heap;
+    int heap_size;
+    int *queue;
+    int queue_front;
+    int queue_size;
+    RatioTournament ratios;
+    int ready_ratios;
+    
+    MetricsAccumulator metrics;
+} OnlineScheduler;
+
+// cost may be NULL for free switches; on_complete is required. Returns
+// ONLINE_ERR_UNSUPPORTED for an algorithm after LJF or a Round Robin
+// quantum below 1, and ONLINE_ERR_CONFIG for a NULL on_complete or a
+// negative cost.
+int online_init(OnlineScheduler *scheduler, int algorithm, long long time_quantum, const SwitchCost *cost,
+                CompletionFn on_complete, void *context);
+
+// Adds a process that arrives no earlier than the previous one and reports
+// every completion this makes certain. Rejects a negative arrival or a
+// burst below 1 with ONLINE_ERR_INVALID, leaving the scheduler as it was.
+int online_push(OnlineScheduler *scheduler, const Process *process);
+
+// Ends the stream: runs every live process to completion
+int online_finish(OnlineScheduler *scheduler);
+
+// Metrics over the processes completed so far, with the run's counters
+int online_metrics(const OnlineScheduler *scheduler, Metrics *metrics);
+
+void online_free(OnlineScheduler *scheduler);
+
+const char *online_error_string(int error);
+
+#endif
@@ -0,0 +1,69 @@
+#include "pool.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    PoolTask task;
+    void *context;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} PoolBatch;
+
+typedef struct {
+    PoolBatch *batch;
+    int worker;
+} PoolWorker;
+
+static int take_index(PoolBatch *batch) {
+    pthread_mutex_lock(&batch->lock);
+    int index = batch->next < batch->count ? batch->next++ : -1;
+    pthread_mutex_unlock(&batch->lock);
+    return index;
+}
+
+static void *work(void *arg) {
+    PoolWorker *worker = (PoolWorker *)arg;
+    int index;
+    while ((index = take_index(worker->batch)) != -1) {
+        worker->batch->task(worker->batch->context, worker->worker, index);
+    }
+    return NULL;
+}
+
+void pool_run(int threads, int count, PoolTask task, void *context) {
+    PoolBatch batch = { task, context, count, 0, PTHREAD_MUTEX_INITIALIZER };
+    if (threads > count) threads = count;
+    if (threads < 1) threads = 1;
+    
+    pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    PoolWorker *workers = (PoolWorker *)malloc(threads * sizeof(PoolWorker));
+    int started = 1;
+    
+    // Threads that cannot be created simply leave more work for the others
+    if (ids != NULL && workers != NULL) {
+        for (int w = 1; w < threads; w++) {
+            workers[started].batch = &batch;
+            workers[started].worker = started;
+            if (pthread_create(&ids[started], NULL, work, &workers[started]) == 0) {
+                started++;
+            }
+        }
+    }
+    
+    PoolWorker self = { &batch, 0 };
+    work(&self);
+    for (int w = 1; w < started; w++) {
+        pthread_join(ids[w], NULL);
+    }
+    
+    pthread_mutex_destroy(&batch.lock);
+    free(ids);
+    free(workers);
+}
+
+int pool_default_threads(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (int)online : 1;
+}
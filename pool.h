@@ -0,0 +1,15 @@
+#ifndef POOL_H
+#define POOL_H
+
+// Runs task(context, worker, index) for every index in [0, count) on up to
+// threads workers, the calling thread being worker 0. Workers take the next
+// index from a shared counter, so one long task does not hold up the rest.
+// worker is in [0, threads) and can select per-worker scratch memory.
+typedef void (*PoolTask)(void *context, int worker, int index);
+
+void pool_run(int threads, int count, PoolTask task, void *context);
+
+// Number of online processors, at least 1
+int pool_default_threads(void);
+
+#endif
@@ -0,0 +1,257 @@
+#include "rbtree.h"
+#include <stdlib.h>
+
+#define NIL -1
+
+static int before(const RbTree *t, int a, int b) {
+    return t->key[a] < t->key[b] || (t->key[a] == t->key[b] && a < b);
+}
+
+static int is_red(const RbTree *t, int i) {
+    return i != NIL && t->red[i];
+}
+
+// Makes child take the place of node under node's parent
+static void replace_child(RbTree *t, int node, int child) {
+    int parent = t->parent[node];
+    if (parent == NIL) {
+        t->root = child;
+    } else if (t->left[parent] == node) {
+        t->left[parent] = child;
+    } else {
+        t->right[parent] = child;
+    }
+    if (child != NIL) {
+        t->parent[child] = parent;
+    }
+}
+
+static void rotate_left(RbTree *t, int x) {
+    int y = t->right[x];
+    t->right[x] = t->left[y];
+    if (t->left[y] != NIL) {
+        t->parent[t->left[y]] = x;
+    }
+    replace_child(t, x, y);
+    t->left[y] = x;
+    t->parent[x] = y;
+}
+
+static void rotate_right(RbTree *t, int x) {
+    int y = t->left[x];
+    t->left[x] = t->right[y];
+    if (t->right[y] != NIL) {
+        t->parent[t->right[y]] = x;
+    }
+    replace_child(t, x, y);
+    t->right[y] = x;
+    t->parent[x] = y;
+}
+
+int rb_tree_init(RbTree *tree, int capacity, const long long *key) {
+    size_t slots = capacity > 0 ? capacity : 1;
+    tree->root = NIL;
+    tree->leftmost = NIL;
+    tree->size = 0;
+    tree->key = key;
+    tree->left = (int *)malloc(slots * sizeof(int));
+    tree->right = (int *)malloc(slots * sizeof(int));
+    tree->parent = (int *)malloc(slots * sizeof(int));
+    tree->red = (unsigned char *)malloc(slots);
+    if (tree->left == NULL || tree->right == NULL || tree->parent == NULL || tree->red == NULL) {
+        rb_tree_free(tree);
+        return -1;
+    }
+    return 0;
+}
+
+void rb_tree_free(RbTree *tree) {
+    free(tree->left);
+    free(tree->right);
+    free(tree->parent);
+    free(tree->red);
+    tree->left = tree->right = tree->parent = NULL;
+    tree->red = NULL;
+}
+
+void rb_tree_insert(RbTree *t, int i) {
+    int parent = NIL;
+    int node = t->root;
+    int leftmost = 1;
+    
+    while (node != NIL) {
+        parent = node;
+        if (before(t, i, node)) {
+            node = t->left[node];
+        } else {
+            node = t->right[node];
+            leftmost = 0;
+        }
+    }
+    
+    t->left[i] = t->right[i] = NIL;
+    t->parent[i] = parent;
+    t->red[i] = 1;
+    if (parent == NIL) {
+        t->root = i;
+    } else if (before(t, i, parent)) {
+        t->left[parent] = i;
+    } else {
+        t->right[parent] = i;
+    }
+    if (leftmost) {
+        t->leftmost = i;
+    }
+    t->size++;
+    
+    // Repair a red node under a red parent
+    while (is_red(t, t->parent[i])) {
+        int p = t->parent[i];
+        int g = t->parent[p];
+        if (p == t->left[g]) {
+            int uncle = t->right[g];
+            if (is_red(t, uncle)) {
+                t->red[p] = t->red[uncle] = 0;
+                t->red[g] = 1;
+                i = g;
+                continue;
+            }
+            if (i == t->right[p]) {
+                rotate_left(t, p);
+                i = p;
+                p = t->parent[i];
+            }
+            t->red[p] = 0;
+            t->red[g] = 1;
+            rotate_right(t, g);
+        } else {
+            int uncle = t->left[g];
+            if (is_red(t, uncle)) {
+                t->red[p] = t->red[uncle] = 0;
+                t->red[g] = 1;
+                i = g;
+                continue;
+            }
+            if (i == t->left[p]) {
+                rotate_right(t, p);
+                i = p;
+                p = t->parent[i];
+            }
+            t->red[p] = 0;
+            t->red[g] = 1;
+            rotate_left(t, g);
+        }
+    }
+    t->red[t->root] = 0;
+}
+
+void rb_tree_remove(RbTree *t, int i) {
+    if (t->leftmost == i) {
+        // The successor of the leftmost node is its right child's leftmost
+        // descendant, or else its parent
+        int next = t->right[i];
+        if (next != NIL) {
+            while (t->left[next] != NIL) {
+                next = t->left[next];
+            }
+        } else {
+            next = t->parent[i];
+        }
+        t->leftmost = next;
+    }
+    
+    // x replaces the node actually unlinked; x_parent is tracked separately
+    // because x may be NIL
+    int x;
+    int x_parent;
+    int removed_red;
+    
+    if (t->left[i] == NIL || t->right[i] == NIL) {
+        x = t->left[i] != NIL ? t->left[i] : t->right[i];
+        x_parent = t->parent[i];
+        removed_red = t->red[i];
+        replace_child(t, i, x);
+    } else {
+        // Two children: the successor y takes i's place and colour
+        int y = t->right[i];
+        while (t->left[y] != NIL) {
+            y = t->left[y];
+        }
+        removed_red = t->red[y];
+        x = t->right[y];
+        if (t->parent[y] == i) {
+            x_parent = y;
+        } else {
+            x_parent = t->parent[y];
+            replace_child(t, y, x);
+            t->right[y] = t->right[i];
+            t->parent[t->right[y]] = y;
+        }
+        replace_child(t, i, y);
+        t->left[y] = t->left[i];
+        t->parent[t->left[y]] = y;
+        t->red[y] = t->red[i];
+    }
+    t->size--;
+    
+    if (removed_red) {
+        return;
+    }
+    
+    // Removing a black node left x's side one black short
+    while (x != t->root && !is_red(t, x)) {
+        if (x == t->left[x_parent]) {
+            int w = t->right[x_parent];
+            if (is_red(t, w)) {
+                t->red[w] = 0;
+                t->red[x_parent] = 1;
+                rotate_left(t, x_parent);
+                w = t->right[x_parent];
+            }
+            if (!is_red(t, t->left[w]) && !is_red(t, t->right[w])) {
+                t->red[w] = 1;
+                x = x_parent;
+                x_parent = t->parent[x];
+                continue;
+            }
+            if (!is_red(t, t->right[w])) {
+                t->red[t->left[w]] = 0;
+                t->red[w] = 1;
+                rotate_right(t, w);
+                w = t->right[x_parent];
+            }
+            t->red[w] = t->red[x_parent];
+            t->red[x_parent] = 0;
+            t->red[t->right[w]] = 0;
+            rotate_left(t, x_parent);
+        } else {
+            int w = t->left[x_parent];
+            if (is_red(t, w)) {
+                t->red[w] = 0;
+                t->red[x_parent] = 1;
+                rotate_right(t, x_parent);
+                w = t->left[x_parent];
+            }
+            if (!is_red(t, t->left[w]) && !is_red(t, t->right[w])) {
+                t->red[w] = 1;
+                x = x_parent;
+                x_parent = t->parent[x];
+                continue;
+            }
+            if (!is_red(t, t->left[w])) {
+                t->red[t->right[w]] = 0;
+                t->red[w] = 1;
+                rotate_left(t, w);
+                w = t->left[x_parent];
+            }
+            t->red[w] = t->red[x_parent];
+            t->red[x_parent] = 0;
+            t->red[t->left[w]] = 0;
+            rotate_right(t, x_parent);
+        }
+        x = t->root;
+    }
+    if (x != NIL) {
+        t->red[x] = 0;
+    }
+}
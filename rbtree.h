@@ -0,0 +1,31 @@
+#ifndef RBTREE_H
+#define RBTREE_H
+
+// Red-black tree over process indices 0..capacity-1, ordered by
+// (key[i], i) with the key column read in place. Links are kept in arrays
+// indexed by process, so the tree never allocates after init, and the
+// leftmost node is cached for O(1) access to the minimum. A process's key
+// must not change while it is in the tree.
+typedef struct {
+    int root;                       // -1 when empty
+    int leftmost;                   // -1 when empty
+    int size;
+    int *left;
+    int *right;
+    int *parent;
+    unsigned char *red;
+    const long long *key;
+} RbTree;
+
+int rb_tree_init(RbTree *tree, int capacity, const long long *key);
+void rb_tree_free(RbTree *tree);
+
+void rb_tree_insert(RbTree *tree, int i);
+void rb_tree_remove(RbTree *tree, int i);
+
+// Process with the smallest (key, index), or -1 when empty
+static inline int rb_tree_first(const RbTree *tree) {
+    return tree->leftmost;
+}
+
+#endif
@@ -0,0 +1,467 @@
+#include "realtime.h"
+#include "heap.h"
+#include "workload.h"
+#include <math.h>
+
+// Heap entry ordered by (key, task, tie). Ready jobs use their priority key
+// and release time; pending periodic releases use the release time alone.
+typedef struct {
+    long long key;
+    long long tie;
+    int task;
+    int job;
+} RtEntry;
+
+typedef struct {
+    RtEntry *items;
+    int size;
+    int capacity;
+} RtHeap;
+
+typedef struct {
+    long long release;
+    long long remaining;
+    long long first_run;                // -1 until the job first runs
+} RtJob;
+
+typedef struct {
+    int algorithm;
+    const Workload *workload;
+    long long horizon;
+    RtStats *stats;
+    RtHeap ready;
+    RtHeap releases;                    // Next release of each periodic task
+    RtJob *jobs;                        // Outstanding jobs, recycled through free_slots
+    int *free_slots;
+    int free_count;
+    int job_capacity;
+    long long backlog;
+    SwitchCost cost;
+    RunCounters counters;
+    Timeline *timeline;
+    MetricsAccumulator acc;
+    Histogram lateness;
+} Rt;
+
+static int rt_before(RtEntry a, RtEntry b) {
+    if (a.key != b.key) return a.key < b.key;
+    if (a.task != b.task) return a.task < b.task;
+    return a.tie < b.tie;
+}
+
+HEAP_DEFINE(rt_entry_heap, RtEntry, rt_before)
+
+static int rt_heap_push(RtHeap *heap, RtEntry entry) {
+    if (heap->size == heap->capacity) {
+        int capacity = heap->capacity > 0 ? heap->capacity * 2 : 64;
+        RtEntry *items = (RtEntry *)realloc(heap->items, (size_t)capacity * sizeof(RtEntry));
+        if (items == NULL) {
+            return -1;
+        }
+        heap->items = items;
+        heap->capacity = capacity;
+    }
+    rt_entry_heap_push(heap->items, &heap->size, entry);
+    return 0;
+}
+
+static RtEntry rt_heap_pop(RtHeap *heap) {
+    return rt_entry_heap_pop(heap->items, &heap->size);
+}
+
+// Ready-queue key of a job of task i released at release
+static long long job_key(const Rt *rt, int i, long long release) {
+    if (rt->algorithm == ALGORITHM_EDF) {
+        return deadline_key(release, workload_deadline(rt->workload, i));
+    }
+    long long rate = workload_rate(rt->workload, i);
+    return rate > 0 ? rate : deadline_key(release, 0);
+}
+
+static int allocate_job(Rt *rt) {
+    if (rt->free_count == 0) {
+        int capacity = rt->job_capacity * 2;
+        RtJob *jobs = (RtJob *)realloc(rt->jobs, (size_t)capacity * sizeof(RtJob));
+        if (jobs == NULL) {
+            return -1;
+        }
+        rt->jobs = jobs;
+        int *slots = (int *)realloc(rt->free_slots, (size_t)capacity * sizeof(int));
+        if (slots == NULL) {
+            return -1;
+        }
+        rt->free_slots = slots;
+        for (int slot = capacity - 1; slot >= rt->job_capacity; slot--) {
+            rt->free_slots[rt->free_count++] = slot;
+        }
+        rt->job_capacity = capacity;
+    }
+    return rt->free_slots[--rt->free_count];
+}
+
+// Queues a job of task i and schedules the task's next release, if it has
+// one before the horizon. Returns 0, or -1 when out of memory.
+static int release_job(Rt *rt, int i, long long release) {
+    int job = allocate_job(rt);
+    if (job < 0) {
+        return -1;
+    }
+    rt->jobs[job].release = release;
+    rt->jobs[job].remaining = rt->workload->burst_time[i];
+    rt->jobs[job].first_run = -1;
+    RtEntry entry = { job_key(rt, i, release), release, i, job };
+    if (rt_heap_push(&rt->ready, entry) != 0) {
+        return -1;
+    }
+    
+    rt->stats->jobs++;
+    rt->stats->task[i].jobs++;
+    if (++rt->backlog > rt->stats->peak_backlog) {
+        rt->stats->peak_backlog = rt->backlog;
+    }
+    
+    long long period = rt->workload->deadline != NULL ? rt->workload->period[i] : 0;
+    if (period > 0 && release < rt->horizon - period) {
+        RtEntry next = { release + period, 0, i, -1 };
+        return rt_heap_push(&rt->releases, next);
+    }
+    return 0;
+}
+
+static int complete_job(Rt *rt, RtEntry entry, long long now) {
+    const RtJob *job = &rt->jobs[entry.job];
+    RtTaskStats *task = &rt->stats->task[entry.task];
+    long long turnaround = now - job->release;
+    
+    metrics_accumulator_add(&rt->acc, turnaround, rt->workload->burst_time[entry.task], 0,
+                            job->first_run - job->release);
+    if (turnaround > task->max_turnaround) {
+        task->max_turnaround = turnaround;
+    }
+    
+    long long deadline = workload_deadline(rt->workload, entry.task);
+    if (deadline > 0) {
+        long long lateness = now - deadline_key(job->release, deadline);
+        rt->stats->deadline_jobs++;
+        if (lateness > task->max_lateness) {
+            task->max_lateness = lateness;
+        }
+        if (lateness > 0) {
+            task->missed++;
+            rt->stats->missed++;
+            if (histogram_record(&rt->lateness, lateness) != 0) {
+                return -1;
+            }
+        }
+    }
+    
+    rt->free_slots[rt->free_count++] = entry.job;
+    rt->backlog--;
+    return 0;
+}
+
+// The event loop: time moves to the next release or the running job's
+// completion, whichever comes first. Releases at one instant are all queued
+// before the CPU picks, and a queued job preempts the running one only when
+// it is strictly ahead of it. A dispatched job starts running once the
+// switch overhead is paid, and can be preempted before then.
+static int rt_simulate(Rt *rt, const int *order) {
+    const Workload *workload = rt->workload;
+    int n = workload->n;
+    int next_arrival = 0;
+    int running = 0;
+    int last_task = -1;
+    int last_ended = 0;
+    RtEntry current = { 0, 0, -1, -1 };
+    long long start = 0;                // The running job does work from here on
+    long long now = 0;
+    
+    while (1) {
+        long long next_release = LLONG_MAX;
+        if (next_arrival < n) {
+            next_release = workload->arrival_time[order[next_arrival]];
+        }
+        if (rt->releases.size > 0 && rt->releases.items[0].key < next_release) {
+            next_release = rt->releases.items[0].key;
+        }
+    
+        if (running) {
+            RtJob *job = &rt->jobs[current.job];
+            long long ran = next_release > start ? next_release - start : 0;
+            if (ran > 0 && job->first_run == -1) {
+                job->first_run = start;
+            }
+            if (rt->timeline != NULL) {
+                timeline_record(rt->timeline, workload->pid[current.task], 0, start,
+                                start + (job->remaining < ran ? job->remaining : ran));
+            }
+            if (job->remaining <= ran) {
+                now = start + job->remaining;
+                running = 0;
+                last_ended = 1;
+                if (complete_job(rt, current, now) != 0) {
+                    return -1;
+                }
+            } else {
+                job->remaining -= ran;
+                start += ran;
+                now = next_release;
+            }
+        } else if (rt->ready.size == 0) {
+            if (next_release == LLONG_MAX) {
+                break;
+            }
+            if (last_task != -1) {
+                rt->counters.idle_transitions++;
+            }
+            now = next_release;
+        }
+    
+        while (next_arrival < n && workload->arrival_time[order[next_arrival]] <= now) {
+            int i = order[next_arrival++];
+            if (release_job(rt, i, workload->arrival_time[i]) != 0) {
+                return -1;
+            }
+        }
+        while (rt->releases.size > 0 && rt->releases.items[0].key <= now) {
+            RtEntry release = rt_heap_pop(&rt->releases);
+            if (release_job(rt, release.task, release.key) != 0) {
+                return -1;
+            }
+        }
+    
+        if (rt->ready.size == 0) {
+            continue;
+        }
+        if (running && rt_before(rt->ready.items[0], current)) {
+            if (rt_heap_push(&rt->ready, current) != 0) {
+                return -1;
+            }
+            // Overhead not yet paid when the job loses the CPU is never spent
+            rt->counters.overhead_time -= start - now;
+            running = 0;
+        }
+        if (!running) {
+            current = rt_heap_pop(&rt->ready);
+            running = 1;
+            int cold = rt->jobs[current.job].remaining < workload->burst_time[current.task];
+            start = now + run_counters_dispatch(&rt->counters, &rt->cost, last_task, last_ended, current.task, cold);
+            last_task = current.task;
+            last_ended = 0;
+        }
+    }
+    
+    rt->stats->total_time = now;
+    return 0;
+}
+
+int rt_run(int algorithm, Workload *workload, const RtConfig *config, RtStats *stats) {
+    int n = workload->n;
+    memset(stats, 0, sizeof(RtStats));
+    
+    if (algorithm != ALGORITHM_EDF && algorithm != ALGORITHM_RM) {
+        return RT_ERR_UNSUPPORTED;
+    }
+    if (config->horizon < 0 || config->cost.context_switch < 0 || config->cost.warmup < 0) {
+        return RT_ERR_CONFIG;
+    }
+    if (workload->bursts != NULL) {
+        return RT_ERR_BURSTS;
+    }
+    if (workload_check(workload) != WORKLOAD_OK) {
+        return RT_ERR_WORKLOAD;
+    }
+    
+    stats->tasks = n;
+    stats->task = (RtTaskStats *)calloc(n > 0 ? n : 1, sizeof(RtTaskStats));
+    if (stats->task == NULL || workload_index(workload) != WORKLOAD_OK) {
+        return RT_ERR_MEMORY;
+    }
+    for (int i = 0; i < n; i++) {
+        stats->task[i].max_lateness = LLONG_MIN;
+    }
+    
+    Rt rt;
+    memset(&rt, 0, sizeof(Rt));
+    rt.algorithm = algorithm;
+    rt.workload = workload;
+    rt.horizon = config->horizon;
+    rt.cost = config->cost;
+    rt.timeline = config->timeline;
+    if (rt.timeline != NULL) {
+        timeline_clear(rt.timeline);
+    }
+    rt.stats = stats;
+    rt.job_capacity = 64;
+    rt.jobs = (RtJob *)malloc(rt.job_capacity * sizeof(RtJob));
+    rt.free_slots = (int *)malloc(rt.job_capacity * sizeof(int));
+    metrics_accumulator_init(&rt.acc);
+    histogram_init(&rt.lateness);
+    
+    int result = RT_ERR_MEMORY;
+    if (rt.jobs != NULL && rt.free_slots != NULL) {
+        for (int slot = rt.job_capacity - 1; slot >= 0; slot--) {
+            rt.free_slots[rt.free_count++] = slot;
+        }
+        if (rt_simulate(&rt, workload->arrival_order) == 0 &&
+            metrics_accumulator_summary(&rt.acc, stats->total_time, &stats->metrics) == 0) {
+            metrics_set_counters(&stats->metrics, &rt.counters);
+            stats->lateness.p50 = histogram_percentile(&rt.lateness, 50);
+            stats->lateness.p95 = histogram_percentile(&rt.lateness, 95);
+            stats->lateness.p99 = histogram_percentile(&rt.lateness, 99);
+            stats->lateness.max = rt.lateness.max;
+            result = RT_OK;
+        }
+    }
+    
+    free(rt.ready.items);
+    free(rt.releases.items);
+    free(rt.jobs);
+    free(rt.free_slots);
+    metrics_accumulator_free(&rt.acc);
+    histogram_free(&rt.lateness);
+    return result;
+}
+
+void rt_stats_free(RtStats *stats) {
+    free(stats->task);
+    stats->task = NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Schedulability
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    long long period;
+    int task;
+} RtRank;
+
+// Rate Monotonic order: shorter period first, then lower index
+static int compare_rank(const void *a, const void *b) {
+    const RtRank *x = (const RtRank *)a;
+    const RtRank *y = (const RtRank *)b;
+    if (x->period != y->period) return x->period < y->period ? -1 : 1;
+    return (x->task > y->task) - (x->task < y->task);
+}
+
+// Worst-case response time of every task against the higher-priority ones,
+// iterated to a fixed point: R = C + sum over them of ceil(R / T) * C.
+// Returns 1 if every task meets its deadline, 0 if one does not, -1 when out
+// of memory.
+static int response_time_analysis(const Workload *workload, int tasks) {
+    RtRank *rank = (RtRank *)malloc((size_t)(tasks > 0 ? tasks : 1) * sizeof(RtRank));
+    if (rank == NULL) {
+        return -1;
+    }
+    int count = 0;
+    for (int i = 0; i < workload->n; i++) {
+        if (workload->period[i] > 0) {
+            rank[count].period = workload->period[i];
+            rank[count++].task = i;
+        }
+    }
+    qsort(rank, count, sizeof(RtRank), compare_rank);
+    
+    int schedulable = 1;
+    for (int k = 0; k < count && schedulable; k++) {
+        int i = rank[k].task;
+        long long deadline = workload_deadline(workload, i);
+        __int128 response = workload->burst_time[i];
+        while (response <= deadline) {
+            __int128 demand = workload->burst_time[i];
+            for (int h = 0; h < k && demand <= deadline; h++) {
+                int j = rank[h].task;
+                __int128 releases = (response + workload->period[j] - 1) / workload->period[j];
+                demand += releases * workload->burst_time[j];
+            }
+            if (demand == response) {
+                break;
+            }
+            response = demand;
+        }
+        schedulable = response <= deadline;
+    }
+    free(rank);
+    return schedulable;
+}
+
+int rt_analyze(int algorithm, const Workload *workload, RtAnalysis *analysis) {
+    int constrained = 0;            // Some deadline is shorter than its period
+    double hyperbolic = 1;
+    
+    memset(analysis, 0, sizeof(RtAnalysis));
+    if (algorithm != ALGORITHM_EDF && algorithm != ALGORITHM_RM) {
+        return RT_ERR_UNSUPPORTED;
+    }
+    if (workload_check(workload) != WORKLOAD_OK) {
+        return RT_ERR_WORKLOAD;
+    }
+    
+    for (int i = 0; workload->deadline != NULL && i < workload->n; i++) {
+        long long period = workload->period[i];
+        if (period == 0) {
+            continue;
+        }
+        long long deadline = workload_deadline(workload, i);
+        double burst = (double)workload->burst_time[i];
+        analysis->tasks++;
+        analysis->utilization += burst / period;
+        analysis->density += burst / (deadline < period ? deadline : period);
+        hyperbolic *= burst / period + 1;
+        constrained |= deadline < period;
+    }
+    
+    int p = analysis->tasks;
+    analysis->bound = p > 0 ? p * (pow(2.0, 1.0 / p) - 1) : 1;
+    if (p == 0) {
+        analysis->verdict = RT_SCHEDULABLE;
+        analysis->test = "no periodic tasks";
+    } else if (analysis->utilization > 1) {
+        analysis->verdict = RT_NOT_SCHEDULABLE;
+        analysis->test = "utilization above 1";
+    } else if (algorithm == ALGORITHM_EDF && !constrained) {
+        analysis->verdict = RT_SCHEDULABLE;
+        analysis->test = "utilization at most 1";
+    } else if (algorithm == ALGORITHM_EDF) {
+        analysis->verdict = analysis->density <= 1 ? RT_SCHEDULABLE : RT_UNKNOWN;
+        analysis->test = analysis->density <= 1 ? "density at most 1" : "density above 1";
+    } else if (!constrained && analysis->utilization <= analysis->bound) {
+        analysis->verdict = RT_SCHEDULABLE;
+        analysis->test = "Liu and Layland bound";
+    } else if (!constrained && hyperbolic <= 2) {
+        analysis->verdict = RT_SCHEDULABLE;
+        analysis->test = "hyperbolic bound";
+    } else if (p <= RT_ANALYSIS_LIMIT) {
+        int result = response_time_analysis(workload, p);
+        if (result < 0) {
+            return RT_ERR_MEMORY;
+        }
+        analysis->verdict = result ? RT_SCHEDULABLE : RT_NOT_SCHEDULABLE;
+        analysis->test = "response-time analysis";
+    } else {
+        analysis->verdict = RT_UNKNOWN;
+        analysis->test = "too many tasks for response-time analysis";
+    }
+    return RT_OK;
+}
+
+const char *rt_verdict_name(int verdict) {
+    switch (verdict) {
+        case RT_SCHEDULABLE: return "schedulable";
+        case RT_NOT_SCHEDULABLE: return "not schedulable";
+        default: return "unknown";
+    }
+}
+
+const char *rt_error_string(int error) {
+    switch (error) {
+        case RT_OK: return "no error";
+        case RT_ERR_MEMORY: return "out of memory";
+        case RT_ERR_UNSUPPORTED: return "algorithm has no real-time mode";
+        case RT_ERR_CONFIG: return "invalid horizon or switch cost";
+        case RT_ERR_BURSTS: return "burst sequences have no real-time mode";
+        case RT_ERR_WORKLOAD: return "negative arrival, deadline or period, or non-positive burst";
+        default: return "unknown error";
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include "scheduling.h"
+
+// Real-time runs of EDF and Rate Monotonic. A process with a period is a
+// periodic task: it releases a job of its burst time at its arrival, then
+// every period after that for as long as the release falls before the
+// horizon. Jobs are created as the clock reaches their release, so memory
+// follows the jobs outstanding, not the length of the horizon. A job is due
+// its relative deadline after its release (the period when it has none);
+// a job that misses its deadline still runs to completion.
+
+#define RT_OK 0
+#define RT_ERR_MEMORY -1
+#define RT_ERR_UNSUPPORTED -2
+#define RT_ERR_CONFIG -3
+#define RT_ERR_BURSTS -4
+#define RT_ERR_WORKLOAD -5               // Fails workload_check()
+
+// Verdicts of rt_analyze()
+#define RT_NOT_SCHEDULABLE 0
+#define RT_SCHEDULABLE 1
+#define RT_UNKNOWN 2
+
+// Rate Monotonic response-time analysis is skipped above this many tasks
+#define RT_ANALYSIS_LIMIT 4096
+
+typedef struct {
+    long long horizon;                  // Periodic releases stop here; 0 for one job per process
+    SwitchCost cost;                    // Charged between jobs of different tasks
+    Timeline *timeline;                 // Records every job's runs when not NULL; cleared first
+} RtConfig;
+
+typedef struct {
+    long long jobs;                     // Jobs released
+    long long missed;                   // Jobs that completed after their deadline
+    long long max_turnaround;           // Longest release-to-completion time
+    long long max_lateness;             // Completion minus deadline, LLONG_MIN without a deadline
+} RtTaskStats;
+
+typedef struct {
+    int tasks;
+    RtTaskStats *task;                  // One entry per process
+    long long jobs;
+    long long deadline_jobs;            // Jobs that had a deadline
+    long long missed;
+    long long peak_backlog;             // Most jobs released but not yet complete
+    long long total_time;
+    LatencySummary lateness;            // How late the jobs that missed were
+    Metrics metrics;                    // Per job, from its release, with the run's counters
+} RtStats;
+
+typedef struct {
+    int tasks;                          // Periodic tasks; one-shot processes are not analysed
+    double utilization;                 // Sum of burst / period
+    double density;                     // Sum of burst / min(deadline, period)
+    double bound;                       // Liu and Layland bound for this many tasks
+    int verdict;
+    const char *test;                   // The test that gave the verdict
+} RtAnalysis;
+
+// Runs EDF or Rate Monotonic with periodic releases up to config->horizon.
+// Builds the arrival index if needed; stats must be released with
+// rt_stats_free() even when the run fails. Returns an RT_ code:
+// RT_ERR_WORKLOAD for a negative arrival, deadline or period, or a burst
+// below 1.
+int rt_run(int algorithm, Workload *workload, const RtConfig *config, RtStats *stats);
+void rt_stats_free(RtStats *stats);
+
+// Schedulability of the periodic tasks under EDF or Rate Monotonic. EDF is
+// decided exactly by utilization when no deadline is shorter than its
+// period, and by density otherwise. Rate Monotonic tries the Liu and Layland
+// and hyperbolic bounds, then response-time analysis, which assumes every
+// task can release a job at the same instant. Returns an RT_ code, with
+// RT_ERR_WORKLOAD as rt_run() does.
+int rt_analyze(int algorithm, const Workload *workload, RtAnalysis *analysis);
+
+const char *rt_verdict_name(int verdict);
+const char *rt_error_string(int error);
+
+#endif
@@ -0,0 +1,38 @@
+#include "rng.h"
+
+static unsigned long long rotl(unsigned long long x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+void rng_seed(Rng *rng, unsigned long long seed) {
+    for (int i = 0; i < 4; i++) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        unsigned long long z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng->s[i] = z ^ (z >> 31);
+    }
+}
+
+unsigned long long rng_next(Rng *rng) {
+    unsigned long long *s = rng->s;
+    unsigned long long result = rotl(s[1] * 5, 7) * 9;
+    unsigned long long t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+unsigned long long rng_below(Rng *rng, unsigned long long bound) {
+    // Reject the top partial copy of [0, bound) so every value is equally likely
+    unsigned long long limit = -bound % bound;
+    unsigned long long x;
+    do {
+        x = rng_next(rng);
+    } while (x < limit);
+    return x % bound;
+}
@@ -0,0 +1,16 @@
+#ifndef RNG_H
+#define RNG_H
+
+// xoshiro256** seeded through splitmix64: fast, and the same sequence for
+// the same seed on every platform
+typedef struct {
+    unsigned long long s[4];
+} Rng;
+
+void rng_seed(Rng *rng, unsigned long long seed);
+unsigned long long rng_next(Rng *rng);
+
+// Uniform in [0, bound), without modulo bias; bound must be positive
+unsigned long long rng_below(Rng *rng, unsigned long long bound);
+
+#endif
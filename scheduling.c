@@ -1,42 +1,64 @@
 #include "scheduling.h"
+#include "arrivals.h"
+#include "heap.h"
+#include "kinetic.h"
+#include "mlfq.h"
+#include "rbtree.h"
+#include "rng.h"
+#include "workload.h"
+#include <limits.h>
 
-void input_processes(Process *processes, int *n) {
-    printf("\nEnter number of processes: ");
-    scanf("%d", n);
+void process_list_init(ProcessList *list) {
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    arena_init(&list->bursts);
+}
+
+// Grows the list to hold at least capacity processes. Returns 0 on success.
+int process_list_reserve(ProcessList *list, int capacity) {
+    if (capacity <= list->capacity) {
+        return 0;
+    }
     
-    for (int i = 0; i < *n; i++) {
-        processes[i].pid = i + 1;
-        printf("\nProcess %d:\n", i + 1);
-        printf("  Arrival time: ");
-        scanf("%d", &processes[i].arrival_time);
-        printf("  Burst time: ");
-        scanf("%d", &processes[i].burst_time);
-        printf("  Priority (0=highest): ");
-        scanf("%d", &processes[i].priority);
-        
-        processes[i].remaining_time = processes[i].burst_time;
-        processes[i].completion_time = 0;
-        processes[i].turnaround_time = 0;
-        processes[i].waiting_time = 0;
-        processes[i].response_time = -1;
+    int new_capacity = list->capacity > 0 ? list->capacity : 16;
+    while (new_capacity < capacity) {
+        new_capacity = new_capacity > INT_MAX / 2 ? INT_MAX : new_capacity * 2;
+    }
+    
+    Process *items = (Process *)realloc(list->items, (size_t)new_capacity * sizeof(Process));
+    if (items == NULL) {
+        return -1;
     }
+    list->items = items;
+    list->capacity = new_capacity;
+    return 0;
 }
 
-void display_processes(Process *processes, int n) {
-    printf("\n%-5s %-10s %-10s %-10s %-10s %-15s %-15s\n",
-           "PID", "Arrival", "Burst", "Priority", "Complete", "Turnaround", "Waiting");
-    printf("==========================================================================================\n");
-    
-    for (int i = 0; i < n; i++) {
-        printf("%-5d %-10d %-10d %-10d %-10d %-15d %-15d\n",
-               processes[i].pid,
-               processes[i].arrival_time,
-               processes[i].burst_time,
-               processes[i].priority,
-               processes[i].completion_time,
-               processes[i].turnaround_time,
-               processes[i].waiting_time);
+// Appends a zeroed process and returns it, or NULL when memory runs out
+Process *process_list_append(ProcessList *list) {
+    if (list->count == INT_MAX || process_list_reserve(list, list->count + 1) != 0) {
+        return NULL;
     }
+    Process *process = &list->items[list->count++];
+    memset(process, 0, sizeof(Process));
+    return process;
+}
+
+// Copies a burst sequence into memory owned by the list, which stays put as
+// the list grows. Returns NULL when memory runs out.
+const long long *process_list_copy_bursts(ProcessList *list, const long long *bursts, int count) {
+    long long *copy = (long long *)arena_alloc(&list->bursts, (size_t)count * sizeof(long long));
+    if (copy != NULL) {
+        memcpy(copy, bursts, (size_t)count * sizeof(long long));
+    }
+    return copy;
+}
+
+void process_list_free(ProcessList *list) {
+    free(list->items);
+    arena_free(&list->bursts);
+    process_list_init(list);
 }
 
 void reset_processes(Process *processes, int n) {
@@ -49,394 +71,1745 @@ void reset_processes(Process *processes, int n) {
     }
 }
 
-void calculate_metrics(Process *processes, int n, int total_time, Metrics *metrics) {
-    float total_waiting = 0, total_turnaround = 0, total_response = 0;
+void metrics_accumulator_init(MetricsAccumulator *acc) {
+    histogram_init(&acc->waiting);
+    histogram_init(&acc->turnaround);
+    histogram_init(&acc->response);
+    acc->count = 0;
+    acc->total_waiting = 0;
+    acc->total_turnaround = 0;
+    acc->total_response = 0;
+    acc->busy_time = 0;
+    acc->io_time = 0;
+    acc->failed = 0;
+}
+
+// Waiting time is the turnaround time less the CPU and I/O bursts
+void metrics_accumulator_add(MetricsAccumulator *acc, long long turnaround_time, long long burst_time,
+                             long long io_time, long long response_time) {
+    long long waiting_time = turnaround_time - burst_time - io_time;
+    
+    acc->count++;
+    acc->total_waiting += waiting_time;
+    acc->total_turnaround += turnaround_time;
+    acc->busy_time += burst_time;
+    acc->io_time += io_time;
+    acc->failed |= histogram_record(&acc->waiting, waiting_time);
+    acc->failed |= histogram_record(&acc->turnaround, turnaround_time);
+    if (response_time != -1) {
+        acc->total_response += response_time;
+        acc->failed |= histogram_record(&acc->response, response_time);
+    }
+}
+
+static void summarize(const Histogram *histogram, LatencySummary *summary) {
+    summary->p50 = histogram_percentile(histogram, 50);
+    summary->p95 = histogram_percentile(histogram, 95);
+    summary->p99 = histogram_percentile(histogram, 99);
+    summary->max = histogram->max;
+}
+
+int metrics_accumulator_summary(const MetricsAccumulator *acc, long long total_time, Metrics *metrics) {
+    long long n = acc->count > 0 ? acc->count : 1;
+    metrics->avg_waiting_time = (double)(acc->total_waiting / n);
+    metrics->avg_turnaround_time = (double)(acc->total_turnaround / n);
+    metrics->avg_response_time = (double)(acc->total_response / n);
+    summarize(&acc->waiting, &metrics->waiting);
+    summarize(&acc->turnaround, &metrics->turnaround);
+    summarize(&acc->response, &metrics->response);
+    metrics->busy_time = acc->busy_time;
+    metrics->idle_time = total_time > acc->busy_time ? total_time - acc->busy_time : 0;
+    metrics->cpu_utilization = total_time > 0 ? (double)acc->busy_time / total_time * 100 : 0;
+    metrics->io_time = acc->io_time;
+    metrics->avg_io_time = (double)acc->io_time / n;
+    metrics->io_busy_time = 0;
+    metrics->io_overlap_time = 0;
+    memset(&metrics->counters, 0, sizeof(RunCounters));
+    return acc->failed ? -1 : 0;
+}
+
+// Switch overhead is time the CPU neither ran a process nor sat idle
+void metrics_set_counters(Metrics *metrics, const RunCounters *counters) {
+    metrics->counters = *counters;
+    metrics->idle_time = metrics->idle_time > counters->overhead_time ? metrics->idle_time - counters->overhead_time
+                                                                      : 0;
+}
+
+void metrics_accumulator_free(MetricsAccumulator *acc) {
+    histogram_free(&acc->waiting);
+    histogram_free(&acc->turnaround);
+    histogram_free(&acc->response);
+}
+
+// Returns 0, or -1 if the latency histograms ran out of memory
+int calculate_metrics(Process *processes, int n, long long total_time, Metrics *metrics) {
+    MetricsAccumulator acc;
+    metrics_accumulator_init(&acc);
     
     for (int i = 0; i < n; i++) {
         processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
         processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
-        
-        total_waiting += processes[i].waiting_time;
-        total_turnaround += processes[i].turnaround_time;
-        if (processes[i].response_time != -1) {
-            total_response += processes[i].response_time;
-        }
+        metrics_accumulator_add(&acc, processes[i].turnaround_time, processes[i].burst_time, 0,
+                                processes[i].response_time);
     }
     
-    metrics->avg_waiting_time = total_waiting / n;
-    metrics->avg_turnaround_time = total_turnaround / n;
-    metrics->avg_response_time = total_response / n;
-    metrics->cpu_utilization = ((float)total_time / total_time) * 100;
+    int result = metrics_accumulator_summary(&acc, total_time, metrics);
+    metrics_accumulator_free(&acc);
+    return result;
 }
 
-// FCFS - First Come First Serve (Non-preemptive)
-void fcfs(Process *processes, int n) {
-    reset_processes(processes, n);
-    
-    // Sort by arrival time
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (processes[j].arrival_time > processes[j + 1].arrival_time) {
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
+int run_state_init(RunState *state, int n) {
+    long long *buffer = (long long *)malloc(3 * (size_t)n * sizeof(long long));
+    if (buffer == NULL) {
+        return -1;
+    }
+    state->n = n;
+    state->remaining_time = buffer;
+    state->completion_time = buffer + n;
+    state->response_time = buffer + 2 * (size_t)n;
+    state->timeline = NULL;
+    return 0;
+}
+
+// With burst sequences, each process starts on its first CPU burst
+void run_state_reset(RunState *state, const Workload *workload) {
+    if (workload->bursts != NULL) {
+        for (int i = 0; i < workload->n; i++) {
+            state->remaining_time[i] = workload->bursts[workload->burst_start[i]];
         }
+    } else {
+        memcpy(state->remaining_time, workload->burst_time, workload->n * sizeof(long long));
     }
-    
-    int current_time = 0;
-    for (int i = 0; i < n; i++) {
-        if (current_time < processes[i].arrival_time) {
-            current_time = processes[i].arrival_time;
+    memset(state->completion_time, 0, workload->n * sizeof(long long));
+    for (int i = 0; i < workload->n; i++) {
+        state->response_time[i] = -1;
+    }
+    state->io_busy_time = 0;
+    state->io_overlap_time = 0;
+    memset(&state->counters, 0, sizeof(RunCounters));
+    if (state->timeline != NULL) {
+        timeline_clear(state->timeline);
+    }
+}
+
+void run_state_bind(RunState *state, int n, long long *remaining_time, long long *completion_time,
+                    long long *response_time) {
+    memset(state, 0, sizeof(RunState));
+    state->n = n;
+    state->remaining_time = remaining_time;
+    state->completion_time = completion_time;
+    state->response_time = response_time;
+}
+
+void run_state_free(RunState *state) {
+    free(state->remaining_time);
+    state->remaining_time = state->completion_time = state->response_time = NULL;
+    state->n = 0;
+}
+
+long long run_total_time(const RunState *state) {
+    long long total_time = 0;
+    for (int i = 0; i < state->n; i++) {
+        if (state->completion_time[i] > total_time) {
+            total_time = state->completion_time[i];
         }
-        
-        processes[i].response_time = current_time - processes[i].arrival_time;
-        current_time += processes[i].burst_time;
-        processes[i].completion_time = current_time;
     }
+    return total_time;
 }
 
-// SJF - Shortest Job First (Non-preemptive)
-void sjf(Process *processes, int n) {
-    reset_processes(processes, n);
+// Returns 0, or -1 if the latency histograms ran out of memory
+int calculate_run_metrics(const Workload *workload, const RunState *state, long long total_time, Metrics *metrics) {
+    MetricsAccumulator acc;
+    metrics_accumulator_init(&acc);
     
-    int completed = 0;
-    int current_time = 0;
+    for (int i = 0; i < workload->n; i++) {
+        metrics_accumulator_add(&acc, state->completion_time[i] - workload->arrival_time[i],
+                                workload->burst_time[i], workload_io_time(workload, i), state->response_time[i]);
+    }
     
-    while (completed < n) {
-        int shortest_idx = -1;
-        int shortest_time = INT_MAX;
-        
-        for (int i = 0; i < n; i++) {
-            if (processes[i].completion_time == 0 && 
-                processes[i].arrival_time <= current_time &&
-                processes[i].burst_time < shortest_time) {
-                shortest_idx = i;
-                shortest_time = processes[i].burst_time;
-            }
+    int result = metrics_accumulator_summary(&acc, total_time, metrics);
+    metrics->io_busy_time = state->io_busy_time;
+    metrics->io_overlap_time = state->io_overlap_time;
+    metrics_set_counters(metrics, &state->counters);
+    metrics_accumulator_free(&acc);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers shared by the algorithms
+// ---------------------------------------------------------------------------
+
+// Linux's sched_prio_to_weight: each nice level is about 10% of CPU apart.
+// CFS weights and lottery tickets both come from the priority field read as
+// a nice level, clamped to -20..19.
+static const long long nice_weights[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15
+};
+
+static long long nice_weight(int priority) {
+    int nice = priority < -20 ? -20 : (priority > 19 ? 19 : priority);
+    return nice_weights[nice + 20];
+}
+
+// ---------------------------------------------------------------------------
+// Event-driven core shared by every algorithm except LRJF and CFS
+// ---------------------------------------------------------------------------
+
+// How the ready queue orders processes. All keyed policies break ties by the
+// lower index.
+typedef enum {
+    READY_FIFO,             // Arrival order, run to completion (FCFS)
+    READY_SHORTEST,         // Burst time (SJF)
+    READY_REMAINING,        // Remaining time, preempted at arrivals (SRJF)
+    READY_ROUND_ROBIN,      // FIFO with a time quantum
+    READY_PRIORITY,         // Priority value (Priority Scheduling)
+    READY_RATIO,            // Highest response ratio (HRRN)
+    READY_LONGEST,          // Burst time, longest first (LJF)
+    READY_LOTTERY,          // Random draw weighted by tickets, with a time quantum
+    READY_STRIDE,           // Lowest pass value, with a time quantum
+    READY_DEADLINE,         // Absolute deadline, preempted at arrivals (EDF)
+    READY_RATE              // Period, preempted at arrivals (Rate Monotonic)
+} ReadyPolicy;
+
+typedef struct {
+    MinHeap heap;           // Keyed policies
+    int *queue;             // FIFO and Round Robin: ring buffer of n slots
+    int front;
+    int size;
+    int *batch;             // Round Robin: arrivals of one time slice
+    RatioTournament ratios; // HRRN
+    long long *tickets;     // Lottery: Fenwick tree over ready tickets, 1-based
+    long long total_tickets;
+    int fenwick_top;        // Lottery: highest power of two <= n
+    Rng rng;                // Lottery
+    long long *pass;        // Stride: per process, -1 until it first joins
+    long long global_pass;  // Stride: pass of the last process dispatched
+} ReadyQueue;
+
+// Pass added per full quantum is STRIDE_ONE / tickets
+#define STRIDE_ONE (1LL << 20)
+
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+
+static void fenwick_add(long long *tree, int n, int idx, long long delta) {
+    for (int i = idx + 1; i <= n; i += i & -i) {
+        tree[i] += delta;
+    }
+}
+
+// Process whose ticket range holds ticket number target (0-based), found by
+// descending the tree in O(log n)
+static int fenwick_find(const long long *tree, int n, int top, long long target) {
+    int pos = 0;
+    for (int step = top; step > 0; step >>= 1) {
+        if (pos + step <= n && tree[pos + step] <= target) {
+            pos += step;
+            target -= tree[pos];
         }
-        
-        if (shortest_idx == -1) {
-            // No process arrived yet
-            for (int i = 0; i < n; i++) {
-                if (processes[i].completion_time == 0) {
-                    current_time = processes[i].arrival_time;
-                    shortest_idx = i;
-                    break;
-                }
+    }
+    return pos;
+}
+
+ALWAYS_INLINE int has_quantum(ReadyPolicy policy) {
+    return policy == READY_ROUND_ROBIN || policy == READY_LOTTERY || policy == READY_STRIDE;
+}
+
+// The running process goes back to the ready queue whenever a process arrives
+ALWAYS_INLINE int preempts_at_arrival(ReadyPolicy policy) {
+    return policy == READY_REMAINING || policy == READY_DEADLINE || policy == READY_RATE;
+}
+
+ALWAYS_INLINE long long ready_key(ReadyPolicy policy, const Workload *workload,
+                                  const RunState *state, int idx) {
+    switch (policy) {
+        // Non-preemptive policies leave remaining_time at the current CPU burst
+        case READY_SHORTEST: return state->remaining_time[idx];
+        case READY_REMAINING: return state->remaining_time[idx];
+        case READY_PRIORITY: return workload->priority[idx];
+        case READY_LONGEST: return -state->remaining_time[idx];
+        case READY_DEADLINE: return deadline_key(workload->arrival_time[idx], workload_deadline(workload, idx));
+        case READY_RATE: {
+            long long rate = workload_rate(workload, idx);
+            return rate > 0 ? rate : deadline_key(workload->arrival_time[idx], 0);
+        }
+        default: return 0;      // Lottery and Stride keep their own state
+    }
+}
+
+ALWAYS_INLINE void ready_push(ReadyPolicy policy, ReadyQueue *ready, const Workload *workload,
+                              const RunState *state, int idx) {
+    switch (policy) {
+        case READY_FIFO:
+        case READY_ROUND_ROBIN:
+            ready->queue[(ready->front + ready->size++) % workload->n] = idx;
+            break;
+        case READY_RATIO:
+            ratio_tournament_insert(&ready->ratios, idx);
+            ready->size++;
+            break;
+        case READY_LOTTERY: {
+            long long tickets = nice_weight(workload->priority[idx]);
+            fenwick_add(ready->tickets, workload->n, idx, tickets);
+            ready->total_tickets += tickets;
+            ready->size++;
+            break;
+        }
+        case READY_STRIDE:
+            // A newcomer, or a process back from I/O that fell behind, joins
+            // at the current global pass
+            if (ready->pass[idx] < ready->global_pass) {
+                ready->pass[idx] = ready->global_pass;
             }
+            heap_push(&ready->heap, ready->pass[idx], idx);
+            break;
+        default:
+            heap_push(&ready->heap, ready_key(policy, workload, state, idx), idx);
+            break;
+    }
+}
+
+ALWAYS_INLINE int ready_empty(ReadyPolicy policy, const ReadyQueue *ready) {
+    switch (policy) {
+        case READY_FIFO:
+        case READY_ROUND_ROBIN:
+        case READY_RATIO:
+        case READY_LOTTERY:
+            return ready->size == 0;
+        default:
+            return ready->heap.size == 0;
+    }
+}
+
+ALWAYS_INLINE int ready_pop(ReadyPolicy policy, ReadyQueue *ready, const Workload *workload,
+                            long long now) {
+    int idx;
+    switch (policy) {
+        case READY_FIFO:
+        case READY_ROUND_ROBIN:
+            idx = ready->queue[ready->front];
+            ready->front = (ready->front + 1) % workload->n;
+            ready->size--;
+            return idx;
+        case READY_RATIO:
+            ratio_tournament_advance(&ready->ratios, now);
+            idx = ratio_tournament_best(&ready->ratios);
+            ratio_tournament_remove(&ready->ratios, idx);
+            ready->size--;
+            return idx;
+        case READY_LOTTERY: {
+            long long draw = (long long)rng_below(&ready->rng, (unsigned long long)ready->total_tickets);
+            idx = fenwick_find(ready->tickets, workload->n, ready->fenwick_top, draw);
+            long long tickets = nice_weight(workload->priority[idx]);
+            fenwick_add(ready->tickets, workload->n, idx, -tickets);
+            ready->total_tickets -= tickets;
+            ready->size--;
+            return idx;
         }
-        
-        if (shortest_idx != -1) {
-            processes[shortest_idx].response_time = current_time - processes[shortest_idx].arrival_time;
-            current_time += processes[shortest_idx].burst_time;
-            processes[shortest_idx].completion_time = current_time;
-            completed++;
+        case READY_STRIDE:
+            idx = heap_pop(&ready->heap).idx;
+            ready->global_pass = ready->pass[idx];
+            return idx;
+        default:
+            return heap_pop(&ready->heap).idx;
+    }
+}
+
+// Stride: advances the pass by the stride, in proportion to the part of the
+// quantum used
+ALWAYS_INLINE void ready_charge(ReadyPolicy policy, ReadyQueue *ready, const Workload *workload, int idx,
+                                long long run_time, long long time_quantum) {
+    if (policy == READY_STRIDE) {
+        if (ready->pass[idx] == -1) {
+            ready->pass[idx] = ready->global_pass;
         }
+        long long stride = STRIDE_ONE / nice_weight(workload->priority[idx]);
+        ready->pass[idx] += stride * run_time / time_quantum;
     }
 }
 
-// SRJF - Shortest Remaining Job First (Preemptive)
-void srjf(Process *processes, int n) {
-    reset_processes(processes, n);
-    
+// Simulates the workload under one policy.
+//
+// Time only moves at events: a decision whenever the CPU is free, plus every
+// arrival for SRJF, EDF and RM. Arrivals are admitted from the arrivals
+// stream, which also hands back processes at the end of their I/O bursts;
+// those count as arrivals everywhere below. When nothing is ready, the clock
+// jumps to the next arrival, which starts at once; under SRJF it runs for
+// one unit before the other arrivals at that time are considered, while EDF
+// and RM admit them all first. Round Robin queues a preempted process before
+// the processes that arrived during its slice, and each such batch in index
+// order. HRRN measures the wait from when a process last became ready, over
+// its current CPU burst.
+//
+// A dispatch pays its switch overhead before the process runs, and the
+// slice is measured from the end of it. Under SRJF, EDF and RM an arrival
+// during the overhead makes the next decision fall right after it, and the
+// process only counts as having run once it does some work.
+//
+// Always inlined with a constant policy, so every algorithm gets its own copy
+// of the loop with the policy's branches resolved at compile time.
+ALWAYS_INLINE int simulate(ReadyPolicy policy, const Workload *workload, RunState *state,
+                           ReadyQueue *ready, long long time_quantum, const SwitchCost *cost) {
+    int n = workload->n;
+    const long long *arrival_time = workload->arrival_time;
+    Arrivals arrivals;
     int completed = 0;
-    int current_time = 0;
+    int last_idx = -1;
+    int last_ended = 0;                 // The last process ran to the end of a CPU burst
+    long long current_time = 0;
+    
+    run_state_reset(state, workload);
+    if (arrivals_init(&arrivals, workload, state) != 0) {
+        arrivals_free(&arrivals);
+        return -1;
+    }
+    if (policy == READY_RATIO && arrivals.position != NULL) {
+        ready->ratios.arrival_time = arrivals.ready_since;
+        ready->ratios.burst_time = arrivals.cpu_burst;
+    }
     
     while (completed < n) {
-        int shortest_idx = -1;
-        int shortest_remaining = INT_MAX;
-        
-        for (int i = 0; i < n; i++) {
-            if (processes[i].remaining_time > 0 && 
-                processes[i].arrival_time <= current_time &&
-                processes[i].remaining_time < shortest_remaining) {
-                shortest_idx = i;
-                shortest_remaining = processes[i].remaining_time;
+        int i;
+        if (policy == READY_ROUND_ROBIN) {
+            int batch_size = 0;
+            while ((i = arrivals_pop(&arrivals, current_time)) != -1) {
+                ready->batch[batch_size++] = i;
+            }
+            if (batch_size > 1) {
+                qsort(ready->batch, batch_size, sizeof(int), compare_int);
+            }
+            for (int k = 0; k < batch_size; k++) {
+                ready_push(policy, ready, workload, state, ready->batch[k]);
+            }
+        } else {
+            if (policy == READY_RATIO) {
+                ratio_tournament_advance(&ready->ratios, current_time);
+            }
+            while ((i = arrivals_pop(&arrivals, current_time)) != -1) {
+                ready_push(policy, ready, workload, state, i);
             }
         }
         
-        if (shortest_idx == -1) {
-            // No process arrived yet
-            int min_arrival = INT_MAX;
-            for (int i = 0; i < n; i++) {
-                if (processes[i].remaining_time > 0 && 
-                    processes[i].arrival_time < min_arrival) {
-                    min_arrival = processes[i].arrival_time;
-                    shortest_idx = i;
-                }
+        int idx;
+        int idle = ready_empty(policy, ready);
+        if (idle) {
+            // Nothing ready: the CPU waits for the next arrival
+            if (last_idx != -1) {
+                state->counters.idle_transitions++;
             }
-            
-            if (shortest_idx != -1) {
-                current_time = processes[shortest_idx].arrival_time;
+            current_time = arrivals_next(&arrivals);
+            if (policy == READY_DEADLINE || policy == READY_RATE) {
+                continue;
             }
+            idx = arrivals_pop(&arrivals, current_time);
+        } else {
+            idx = ready_pop(policy, ready, workload, current_time);
         }
         
-        if (shortest_idx != -1) {
-            if (processes[shortest_idx].response_time == -1) {
-                processes[shortest_idx].response_time = current_time - processes[shortest_idx].arrival_time;
-            }
-            
-            processes[shortest_idx].remaining_time--;
-            current_time++;
-            
-            if (processes[shortest_idx].remaining_time == 0) {
-                processes[shortest_idx].completion_time = current_time;
-                completed++;
+        // Non-preemptive policies keep remaining_time at the burst, as the
+        // original implementations did
+        int preemptive = preempts_at_arrival(policy) || has_quantum(policy);
+        int cold = preemptive && state->remaining_time[idx] < arrivals_burst(&arrivals, idx);
+        current_time += run_counters_dispatch(&state->counters, cost, last_idx, last_ended, idx, cold);
+        last_idx = idx;
+        
+        long long run_time = state->remaining_time[idx];
+        if (has_quantum(policy) && run_time > time_quantum) {
+            run_time = time_quantum;
+        }
+        if (preempts_at_arrival(policy)) {
+            long long until_arrival = arrivals_next(&arrivals) - current_time;
+            if (idle) {
+                run_time = 1;
+            } else if (until_arrival < run_time) {
+                run_time = until_arrival > 0 ? until_arrival : 0;
             }
         }
+        
+        if (state->response_time[idx] == -1 && run_time > 0) {
+            state->response_time[idx] = current_time - arrival_time[idx];
+        }
+        
+        long long remaining = state->remaining_time[idx] - run_time;
+        if (preemptive) {
+            state->remaining_time[idx] = remaining;
+        }
+        if (state->timeline != NULL) {
+            timeline_record(state->timeline, workload->pid[idx], 0, current_time, current_time + run_time);
+        }
+        current_time += run_time;
+        ready_charge(policy, ready, workload, idx, run_time, time_quantum);
+        
+        last_ended = remaining == 0;
+        if (remaining == 0) {
+            completed += arrivals_finish(&arrivals, idx, current_time);
+        } else {
+            ready_push(policy, ready, workload, state, idx);
+        }
     }
+    
+    arrivals_free(&arrivals);
+    return 0;
 }
 
-// Round Robin (Preemptive)
-void round_robin(Process *processes, int n, int time_quantum) {
-    reset_processes(processes, n);
-    
-    int completed = 0;
-    int current_time = 0;
-    int *queue = (int *)malloc(n * sizeof(int));
-    int queue_front = 0, queue_rear = 0;
-    int *in_queue = (int *)malloc(n * sizeof(int));
-    memset(in_queue, 0, n * sizeof(int));
+// Allocates the ready queue a policy needs. Returns 0 on success.
+static int ready_init(ReadyQueue *ready, ReadyPolicy policy, const Workload *workload) {
+    int n = workload->n;
+    size_t slots = n > 0 ? n : 1;
+    memset(ready, 0, sizeof(ReadyQueue));
     
-    // Initially add all arrived processes
-    for (int i = 0; i < n; i++) {
-        if (processes[i].arrival_time == 0) {
-            queue[queue_rear++] = i;
-            in_queue[i] = 1;
+    switch (policy) {
+        case READY_FIFO:
+            ready->queue = (int *)malloc(slots * sizeof(int));
+            return ready->queue == NULL ? -1 : 0;
+        case READY_ROUND_ROBIN:
+            ready->queue = (int *)malloc(slots * sizeof(int));
+            ready->batch = (int *)malloc(slots * sizeof(int));
+            return ready->queue == NULL || ready->batch == NULL ? -1 : 0;
+        case READY_RATIO:
+            return ratio_tournament_init(&ready->ratios, n, workload->arrival_time, workload->burst_time);
+        case READY_LOTTERY:
+            ready->tickets = (long long *)calloc(n + 1, sizeof(long long));
+            ready->fenwick_top = 1;
+            while (ready->fenwick_top * 2 <= n) {
+                ready->fenwick_top *= 2;
+            }
+            return ready->tickets == NULL ? -1 : 0;
+        case READY_STRIDE:
+            ready->heap.items = (KeyedIndex *)malloc(slots * sizeof(KeyedIndex));
+            ready->pass = (long long *)malloc(slots * sizeof(long long));
+            if (ready->heap.items == NULL || ready->pass == NULL) {
+                return -1;
+            }
+            for (int i = 0; i < n; i++) {
+                ready->pass[i] = -1;
+            }
+            return 0;
+        default:
+            ready->heap.items = (KeyedIndex *)malloc(slots * sizeof(KeyedIndex));
+            return ready->heap.items == NULL ? -1 : 0;
+    }
+}
+
+static void ready_free(ReadyQueue *ready, ReadyPolicy policy) {
+    free(ready->heap.items);
+    free(ready->queue);
+    free(ready->batch);
+    free(ready->tickets);
+    free(ready->pass);
+    if (policy == READY_RATIO) {
+        ratio_tournament_free(&ready->ratios);
+    }
+}
+
+// Runs one policy with its own ready queue. The quantum only matters to the
+// policies that have one, and the seed to Lottery. Returns 0, or -1 when out
+// of memory.
+ALWAYS_INLINE int run_policy(ReadyPolicy policy, const Workload *workload, RunState *state,
+                             const ScheduleOptions *options) {
+    ReadyQueue ready;
+    int result = -1;
+    if (ready_init(&ready, policy, workload) == 0) {
+        rng_seed(&ready.rng, options->seed);
+        result = simulate(policy, workload, state, &ready, options->time_quantum, &options->cost);
+    }
+    if (result != 0) {
+        run_state_reset(state, workload);
+    }
+    ready_free(&ready, policy);
+    return result;
+}
+
+// FCFS - First Come First Serve (Non-preemptive)
+int fcfs_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_FCFS, workload, state, 0);
+}
+
+// SJF - Shortest Job First (Non-preemptive)
+int sjf_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_SJF, workload, state, 0);
+}
+
+// SRJF - Shortest Remaining Job First (Preemptive)
+//
+// The running process can only lose the CPU when a new process arrives, so
+// it runs straight to the next arrival or its completion. The heap key
+// (remaining_time, index) reproduces the tick-by-tick tie-breaking.
+int srjf_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_SRJF, workload, state, 0);
+}
+
+// Round Robin (Preemptive)
+//
+// A process is in the ready queue at most once, so a ring buffer of n slots
+// is enough.
+int round_robin_run_with(const Workload *workload, RunState *state, long long time_quantum,
+                         const SwitchCost *cost, int *queue, int *batch) {
+    if (time_quantum <= 0 || cost->context_switch < 0 || cost->warmup < 0) {
+        run_state_reset(state, workload);
+        return SCHEDULE_ERR_CONFIG;
+    }
+    if (workload_check(workload) != WORKLOAD_OK) {
+        run_state_reset(state, workload);
+        return SCHEDULE_ERR_WORKLOAD;
+    }
+    ReadyQueue ready;
+    memset(&ready, 0, sizeof(ReadyQueue));
+    ready.queue = queue;
+    ready.batch = batch;
+    if (simulate(READY_ROUND_ROBIN, workload, state, &ready, time_quantum, cost) != 0) {
+        run_state_reset(state, workload);
+        return SCHEDULE_ERR_MEMORY;
+    }
+    return SCHEDULE_OK;
+}
+
+int round_robin_run(const Workload *workload, RunState *state, long long time_quantum) {
+    return run_schedule(ALGORITHM_ROUND_ROBIN, workload, state, time_quantum);
+}
+
+// Priority Scheduling (Non-preemptive)
+int priority_scheduling_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_PRIORITY, workload, state, 0);
+}
+
+// Lottery Scheduling (Preemptive)
+//
+// Every quantum, a ticket is drawn uniformly from the ready processes'
+// tickets and its holder runs. Tickets live in a Fenwick tree indexed by
+// process, so a draw and a ticket update are both O(log n). The same seed
+// gives the same schedule.
+int lottery_run(const Workload *workload, RunState *state, long long time_quantum, unsigned long long seed) {
+    ScheduleOptions options;
+    schedule_options_init(&options, time_quantum);
+    options.seed = seed;
+    return run_schedule_with(ALGORITHM_LOTTERY, workload, state, &options);
+}
+
+// Stride Scheduling (Preemptive)
+//
+// The deterministic counterpart of Lottery: each process advances its pass
+// by STRIDE_ONE / tickets per quantum used, and the ready process with the
+// lowest (pass, index) runs next, from a heap.
+int stride_run(const Workload *workload, RunState *state, long long time_quantum) {
+    return run_schedule(ALGORITHM_STRIDE, workload, state, time_quantum);
+}
+
+// EDF - Earliest Deadline First (Preemptive)
+//
+// The ready process due first runs; a periodic process without a deadline
+// is due one period after it arrives. Each process releases one job here;
+// see realtime.h for periodic releases and deadline accounting.
+int edf_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_EDF, workload, state, 0);
+}
+
+// RM - Rate Monotonic (Preemptive)
+//
+// Fixed priorities: the shorter the period, the higher the priority. A
+// one-shot process ranks by its relative deadline instead.
+int rate_monotonic_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_RM, workload, state, 0);
+}
+
+// MLFQ - Multi-Level Feedback Queue (Preemptive)
+//
+// MLFQ_LEVELS levels with quanta doubling from time_quantum; see mlfq.h
+int mlfq_run(const Workload *workload, RunState *state, long long time_quantum) {
+    return run_schedule(ALGORITHM_MLFQ, workload, state, time_quantum);
+}
+
+// HRRN - Highest Response Ratio Next (Non-preemptive)
+int hrrn_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_HRRN, workload, state, 0);
+}
+
+// LJF - Longest Job First (Non-preemptive)
+int ljf_run(const Workload *workload, RunState *state) {
+    return run_schedule(ALGORITHM_LJF, workload, state, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Preemptive Priority with aging
+// ---------------------------------------------------------------------------
+
+// Ready-queue bookkeeping for aging: the current (aged) priority of each
+// process, when it last joined the queue, and when it next moves up a level
+typedef struct {
+    const Workload *workload;
+    long long aging_interval;
+    long long *effective;
+    long long *ready_since;
+    long long *next_aging;
+    IndexedHeap ready;              // By (effective, ready_since, index)
+    IndexedHeap aging;              // Waiting processes that can still age, by next_aging
+} AgingQueue;
+
+// Queues a process at its base priority; aging counts from now
+static void aging_enqueue(AgingQueue *q, int i, long long now) {
+    q->effective[i] = q->workload->priority[i];
+    q->ready_since[i] = now;
+    indexed_push(&q->ready, i);
+    if (q->aging_interval > 0 && q->effective[i] > 0) {
+        q->next_aging[i] = now + q->aging_interval;
+        indexed_push(&q->aging, i);
+    }
+}
+
+static int aging_dequeue(AgingQueue *q) {
+    int i = q->ready.heap[0];
+    indexed_remove(&q->ready, i);
+    if (q->aging.pos[i] != -1) {
+        indexed_remove(&q->aging, i);
+    }
+    return i;
+}
+
+// Applies every aging step due at now: one level per interval waited,
+// stopping at priority 0
+static void aging_advance(AgingQueue *q, long long now) {
+    while (q->aging.size > 0 && q->next_aging[q->aging.heap[0]] <= now) {
+        int i = q->aging.heap[0];
+        q->effective[i]--;
+        indexed_update(&q->ready, i);
+        if (q->effective[i] > 0) {
+            q->next_aging[i] += q->aging_interval;
+            indexed_sift_down(&q->aging, 0);
+        } else {
+            indexed_remove(&q->aging, i);
         }
     }
+}
+
+// Preemptive Priority with aging
+//
+// The ready process with the best (lowest) effective priority runs, and an
+// arrival or an aged process with a strictly better one preempts it. A
+// waiting process improves by one level per aging_interval waited, down to 0
+// (0 disables aging); it runs at the level it reached, and a preempted
+// process rejoins the queue at its base priority. Equal levels go to the
+// process that has waited longest, then the lower index.
+//
+// Time moves from event to event: arrivals, completions and aging steps. A
+// process back from I/O rejoins at its base priority like an arrival.
+// Each aging step is an O(log n) decrease-key on the ready heap, applied
+// only when the clock reaches it, and a waiting process takes at most
+// priority steps before it reaches level 0. A dispatched process does no
+// work until its switch overhead is paid, and can be preempted before then.
+static int priority_preemptive_simulate(const Workload *workload, RunState *state, long long aging_interval,
+                                         const SwitchCost *cost) {
+    int n = workload->n;
+    run_state_reset(state, workload);
     
-    while (completed < n) {
-        if (queue_front == queue_rear) {
-            // Queue is empty, find next arriving process
-            int min_arrival = INT_MAX;
-            int next_process = -1;
-            for (int i = 0; i < n; i++) {
-                if (processes[i].remaining_time > 0 && 
-                    processes[i].arrival_time > current_time &&
-                    processes[i].arrival_time < min_arrival) {
-                    min_arrival = processes[i].arrival_time;
-                    next_process = i;
-                }
+    Arrivals arrivals;
+    int stream = arrivals_init(&arrivals, workload, state);
+    AgingQueue q;
+    memset(&q, 0, sizeof(AgingQueue));
+    q.workload = workload;
+    q.aging_interval = aging_interval > 0 ? aging_interval : 0;
+    q.effective = (long long *)malloc((n > 0 ? n : 1) * sizeof(long long));
+    q.ready_since = (long long *)malloc((n > 0 ? n : 1) * sizeof(long long));
+    q.next_aging = (long long *)malloc((n > 0 ? n : 1) * sizeof(long long));
+    int heaps = indexed_init(&q.ready, n, q.effective, q.ready_since);
+    heaps |= indexed_init(&q.aging, n, q.next_aging, NULL);
+    int result = -1;
+    
+    if (stream == 0 && q.effective != NULL && q.ready_since != NULL && q.next_aging != NULL &&
+        heaps == 0) {
+        result = 0;
+        int completed = 0;
+        int running = -1;
+        int last = -1;
+        int last_ended = 0;
+        long long running_level = 0;
+        long long start = 0;            // The running process does work from here on
+        long long current_time = 0;
+        
+        while (completed < n) {
+            // Next event: an arrival, the running process's completion or an
+            // aging step
+            long long next = arrivals_next(&arrivals);
+            if (running != -1 && start + state->remaining_time[running] < next) {
+                next = start + state->remaining_time[running];
             }
-            
-            if (next_process != -1) {
-                current_time = processes[next_process].arrival_time;
-                queue[queue_rear++] = next_process;
-                in_queue[next_process] = 1;
+            if (q.aging.size > 0 && q.next_aging[q.aging.heap[0]] < next) {
+                next = q.next_aging[q.aging.heap[0]];
             }
-        }
-        
-        if (queue_front < queue_rear) {
-            int idx = queue[queue_front++];
             
-            if (processes[idx].response_time == -1) {
-                processes[idx].response_time = current_time - processes[idx].arrival_time;
+            current_time = next;
+            if (running != -1 && current_time > start) {
+                if (state->response_time[running] == -1) {
+                    state->response_time[running] = start - workload->arrival_time[running];
+                }
+                state->remaining_time[running] -= current_time - start;
+                if (state->timeline != NULL) {
+                    timeline_record(state->timeline, workload->pid[running], 0, start, current_time);
+                }
+                start = current_time;
+                if (state->remaining_time[running] == 0) {
+                    completed += arrivals_finish(&arrivals, running, current_time);
+                    running = -1;
+                    last_ended = 1;
+                }
             }
-            
-            int time_used = (processes[idx].remaining_time < time_quantum) ? 
-                            processes[idx].remaining_time : time_quantum;
-            
-            processes[idx].remaining_time -= time_used;
-            current_time += time_used;
-            
-            if (processes[idx].remaining_time == 0) {
-                processes[idx].completion_time = current_time;
-                completed++;
-            } else {
-                // Add back to queue
-                queue[queue_rear++] = idx;
+            aging_advance(&q, current_time);
+            int i;
+            while ((i = arrivals_pop(&arrivals, current_time)) != -1) {
+                aging_enqueue(&q, i, current_time);
             }
             
-            // Add newly arrived processes
-            for (int i = 0; i < n; i++) {
-                if (processes[i].arrival_time <= current_time && 
-                    processes[i].remaining_time > 0 && 
-                    in_queue[i] == 0) {
-                    queue[queue_rear++] = i;
-                    in_queue[i] = 1;
+            if (q.ready.size == 0) {
+                if (running == -1 && completed < n) {
+                    state->counters.idle_transitions++;
                 }
+                continue;
             }
+            if (running != -1) {
+                if (q.effective[q.ready.heap[0]] >= running_level) {
+                    continue;
+                }
+                // Overhead not yet paid when the process loses the CPU is never spent
+                if (start > current_time) {
+                    state->counters.overhead_time -= start - current_time;
+                }
+                aging_enqueue(&q, running, current_time);
+            }
+            running = aging_dequeue(&q);
+            running_level = q.effective[running];
+            int cold = state->remaining_time[running] < arrivals_burst(&arrivals, running);
+            start = current_time + run_counters_dispatch(&state->counters, cost, last, last_ended, running, cold);
+            last = running;
+            last_ended = 0;
         }
     }
     
-    free(queue);
-    free(in_queue);
+    arrivals_free(&arrivals);
+    indexed_free(&q.ready);
+    indexed_free(&q.aging);
+    free(q.effective);
+    free(q.ready_since);
+    free(q.next_aging);
+    return result;
 }
 
-// Priority Scheduling (Non-preemptive)
-void priority_scheduling(Process *processes, int n) {
-    reset_processes(processes, n);
+int priority_preemptive_run(const Workload *workload, RunState *state, long long aging_interval) {
+    ScheduleOptions options;
+    schedule_options_init(&options, 0);
+    options.aging_interval = aging_interval;
+    return run_schedule_with(ALGORITHM_PRIORITY_AGING, workload, state, &options);
+}
+
+// LRJF bookkeeping. Ready processes with equal remaining time take turns one
+// unit at a time in index order, so simulating them tick by tick costs
+// O(burst). Instead, ready processes are kept in groups: every member of a
+// group has remaining_time == level (untouched this round) or level - 1
+// (already served this round). A group is a treap ordered by process index,
+// so a whole round, or the first k untouched members of one, is applied at once.
+typedef struct {
+    int left, right;
+    unsigned priority;
+    int size;           // Members in this subtree
+    int untouched;      // Members still at the group level
+    int fresh;          // Members that have not run in their current CPU burst
+    char served;        // Already ran in the current round
+    char pending;       // Lazy assignment of served to the subtree (0 = none, 1 = clear, 2 = set)
+} BandNode;
+
+typedef struct {
+    const Workload *workload;
+    RunState *state;
+    BandNode *nodes;    // Node i + 1 belongs to process i, node 0 is the empty tree
+    unsigned char *started;     // Per process: has run in its current CPU burst
+    long long step;     // Time to serve a member: one unit plus a context switch
+    long long warmup;   // Added for a member that has started
+} Band;
+
+static unsigned mix_hash(unsigned x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+static void band_apply(Band *band, int t, int served) {
+    if (!t) return;
+    BandNode *node = &band->nodes[t];
+    node->served = (char)served;
+    node->untouched = served ? 0 : node->size;
+    node->pending = served ? 2 : 1;
+}
+
+static void band_push(Band *band, int t) {
+    BandNode *node = &band->nodes[t];
+    if (node->pending) {
+        band_apply(band, node->left, node->pending == 2);
+        band_apply(band, node->right, node->pending == 2);
+        node->pending = 0;
+    }
+}
+
+static void band_update(Band *band, int t) {
+    BandNode *node = &band->nodes[t];
+    BandNode *left = &band->nodes[node->left];
+    BandNode *right = &band->nodes[node->right];
     
-    int completed = 0;
-    int current_time = 0;
+    node->size = 1 + left->size + right->size;
+    node->untouched = !node->served + left->untouched + right->untouched;
+    node->fresh = !band->started[t - 1] + left->fresh + right->fresh;
+}
+
+static void band_init(Band *band, int t) {
+    BandNode *node = &band->nodes[t];
+    node->left = node->right = 0;
+    node->served = node->pending = 0;
+    band_update(band, t);
+}
+
+// Splits t into members with index below key and the rest
+static void band_split_index(Band *band, int t, int key, int *lo, int *hi) {
+    if (!t) {
+        *lo = *hi = 0;
+        return;
+    }
+    band_push(band, t);
+    if (t < key) {
+        band_split_index(band, band->nodes[t].right, key, &band->nodes[t].right, hi);
+        *lo = t;
+    } else {
+        band_split_index(band, band->nodes[t].left, key, lo, &band->nodes[t].left);
+        *hi = t;
+    }
+    band_update(band, t);
+}
+
+// Splits t right after its count-th untouched member
+static void band_split_untouched(Band *band, int t, int count, int *lo, int *hi) {
+    if (!t) {
+        *lo = *hi = 0;
+        return;
+    }
+    band_push(band, t);
+    BandNode *node = &band->nodes[t];
+    int left_untouched = band->nodes[node->left].untouched;
     
-    while (completed < n) {
-        int highest_priority_idx = -1;
-        int highest_priority = INT_MAX;
-        
-        for (int i = 0; i < n; i++) {
-            if (processes[i].completion_time == 0 && 
-                processes[i].arrival_time <= current_time &&
-                processes[i].priority < highest_priority) {
-                highest_priority_idx = i;
-                highest_priority = processes[i].priority;
-            }
+    if (count <= left_untouched) {
+        band_split_untouched(band, node->left, count, lo, &node->left);
+        *hi = t;
+    } else {
+        band_split_untouched(band, node->right, count - left_untouched - !node->served, &node->right, hi);
+        *lo = t;
+    }
+    band_update(band, t);
+}
+
+// Concatenates two treaps where every index in lo is below every index in hi
+static int band_merge(Band *band, int lo, int hi) {
+    if (!lo) return hi;
+    if (!hi) return lo;
+    if (band->nodes[lo].priority > band->nodes[hi].priority) {
+        band_push(band, lo);
+        band->nodes[lo].right = band_merge(band, band->nodes[lo].right, hi);
+        band_update(band, lo);
+        return lo;
+    }
+    band_push(band, hi);
+    band->nodes[hi].left = band_merge(band, lo, band->nodes[hi].left);
+    band_update(band, hi);
+    return hi;
+}
+
+// Union of two treaps with interleaved indices
+static int band_union(Band *band, int a, int b) {
+    if (!a) return b;
+    if (!b) return a;
+    if (band->nodes[a].priority < band->nodes[b].priority) {
+        int swap = a;
+        a = b;
+        b = swap;
+    }
+    band_push(band, a);
+    int lo, hi;
+    band_split_index(band, b, a, &lo, &hi);
+    band->nodes[a].left = band_union(band, band->nodes[a].left, lo);
+    band->nodes[a].right = band_union(band, band->nodes[a].right, hi);
+    band_update(band, a);
+    return a;
+}
+
+// Node of the first untouched member of t, which must have one. When every
+// member is untouched that is the leftmost node, found without pushing.
+static int band_first_untouched(Band *band, int t) {
+    if (band->nodes[t].untouched == band->nodes[t].size) {
+        while (band->nodes[t].left) {
+            t = band->nodes[t].left;
+        }
+        return t;
+    }
+    while (1) {
+        band_push(band, t);
+        BandNode *node = &band->nodes[t];
+        if (band->nodes[node->left].untouched > 0) {
+            t = node->left;
+        } else if (!node->served) {
+            return t;
+        } else {
+            t = node->right;
         }
+    }
+}
+
+// Node of the last member of t
+static int band_last(const Band *band, int t) {
+    while (band->nodes[t].right) {
+        t = band->nodes[t].right;
+    }
+    return t;
+}
+
+// Largest count, at most limit, of untouched members of t that can be served
+// one after another, each with a full switch, in less than budget
+static int band_count_within(Band *band, int t, int limit, long long budget) {
+    if (band->warmup == 0) {
+        // Every member costs one step
+        long long fit = (budget - 1) / band->step;
+        return fit < limit ? (int)fit : limit;
+    }
+    int count = 0;
+    while (t && count < limit) {
+        band_push(band, t);
+        BandNode *node = &band->nodes[t];
+        BandNode *left = &band->nodes[node->left];
+        __int128 time = (__int128)left->untouched * band->step +
+                        (__int128)(left->untouched - left->fresh) * band->warmup;
         
-        if (highest_priority_idx == -1) {
-            // No process arrived yet
-            for (int i = 0; i < n; i++) {
-                if (processes[i].completion_time == 0) {
-                    current_time = processes[i].arrival_time;
-                    highest_priority_idx = i;
-                    break;
-                }
+        if (left->untouched > limit - count || time >= budget) {
+            t = node->left;
+            continue;
+        }
+        count += left->untouched;
+        budget -= (long long)time;
+        if (!node->served) {
+            long long own = band->step + band->warmup * band->started[t - 1];
+            if (count == limit || own >= budget) {
+                return count;
             }
+            count++;
+            budget -= own;
         }
-        
-        if (highest_priority_idx != -1) {
-            processes[highest_priority_idx].response_time = current_time - processes[highest_priority_idx].arrival_time;
-            current_time += processes[highest_priority_idx].burst_time;
-            processes[highest_priority_idx].completion_time = current_time;
-            completed++;
+        t = node->right;
+    }
+    return count;
+}
+
+// Records the first run of members that have not run in their current CPU
+// burst. The untouched members of t are served one unit each in index
+// order: the one of rank r, with f of those before it fresh, starts running
+// at origin + r * step + (r - f) * warmup.
+static void band_first_run(Band *band, int t, int rank, int fresh, long long origin) {
+    if (!t || band->nodes[t].fresh == 0) return;
+    band_push(band, t);
+    BandNode *node = &band->nodes[t];
+    int i = t - 1;
+    
+    int left_fresh = band->nodes[node->left].fresh;
+    band_first_run(band, node->left, rank, fresh, origin);
+    rank += band->nodes[node->left].untouched;
+    fresh += left_fresh;
+    if (!band->started[i]) {
+        if (band->state->response_time[i] == -1) {
+            band->state->response_time[i] = origin + rank * band->step + (rank - fresh) * band->warmup -
+                                            band->workload->arrival_time[i];
         }
+        band->started[i] = 1;
+        fresh++;
     }
+    band_first_run(band, node->right, rank + !node->served, fresh, origin);
+    band_update(band, t);
 }
 
-// HRRN - Highest Response Ratio Next (Non-preemptive)
-void hrrn(Process *processes, int n) {
-    reset_processes(processes, n);
+// Completes every member of t, one unit each in index order: the one of
+// rank r, with c members up to and including it started, starts running at
+// origin + r * step + c * warmup
+static void band_complete(Band *band, int t, int *rank, int *cold, long long origin) {
+    if (!t) return;
+    band_push(band, t);
+    BandNode *node = &band->nodes[t];
+    int i = t - 1;
     
+    band_complete(band, node->left, rank, cold, origin);
+    *cold += band->started[i];
+    long long start = origin + *rank * band->step + *cold * band->warmup;
+    if (band->state->response_time[i] == -1) {
+        band->state->response_time[i] = start - band->workload->arrival_time[i];
+    }
+    band->state->remaining_time[i] = 0;
+    band->state->completion_time[i] = start + 1;
+    (*rank)++;
+    band_complete(band, node->right, rank, cold, origin);
+}
+
+// Records the runs of the untouched members of t, one unit each in index
+// order, with the start times band_complete() gives them
+static void band_record(Band *band, int t, int *rank, int *cold, long long origin) {
+    if (!t || band->nodes[t].untouched == 0) return;
+    band_push(band, t);
+    BandNode *node = &band->nodes[t];
+    int i = t - 1;
+    
+    band_record(band, node->left, rank, cold, origin);
+    if (!node->served) {
+        *cold += band->started[i];
+        long long start = origin + *rank * band->step + *cold * band->warmup;
+        timeline_record(band->state->timeline, band->workload->pid[i], 0, start, start + 1);
+        (*rank)++;
+    }
+    band_record(band, node->right, rank, cold, origin);
+}
+
+// LRJF - Longest Remaining Job First (Preemptive)
+//
+// Event-driven: groups are kept in a heap keyed by level. The top group
+// serves its untouched members until the next arrival; rounds in which
+// nothing can change are skipped by lowering the level arithmetically.
+// Results match the tick-by-tick definition, including per-tick rotation
+// between tied processes.
+//
+// With burst sequences, a process that ends a CPU burst leaves its group
+// for I/O and comes back as a new single-member group. At level 1 members
+// are then served one at a time, since an I/O burst that starts with one
+// member's completion can end before the round does.
+//
+// Every member served pays a context switch, and a warmup when it has run
+// before in its burst, except a process that keeps the CPU. A member that
+// has been dispatched runs its unit even if a process arrives meanwhile.
+
+// Starts a single-member group for process i at its remaining time
+static void lrjf_admit(Band *band, MinHeap *groups, int *group_root, long long *group_level, int *free_groups,
+                       int *free_count, int i) {
+    int g = free_groups[--*free_count];
+    band_init(band, i + 1);
+    group_root[g] = i + 1;
+    group_level[g] = band->state->remaining_time[i];
+    heap_push(groups, -group_level[g], g);
+}
+
+static int lrjf_simulate(const Workload *workload, RunState *state, const SwitchCost *cost) {
+    int n = workload->n;
+    size_t count = n > 0 ? n : 1;
+    run_state_reset(state, workload);
+    
+    Arrivals arrivals;
+    int stream = arrivals_init(&arrivals, workload, state);
+    Band band = { workload, state, (BandNode *)calloc(count + 1, sizeof(BandNode)),
+                  (unsigned char *)calloc(count, 1), 1 + cost->context_switch, cost->warmup };
+    int *group_root = (int *)malloc(count * sizeof(int));
+    long long *group_level = (long long *)malloc(count * sizeof(long long));
+    int *free_groups = (int *)malloc(count * sizeof(int));  // Group slots not in use
+    int free_count = n;
+    MinHeap groups = { (KeyedIndex *)malloc(count * sizeof(KeyedIndex)), 0 };
+    RunCounters *counters = &state->counters;
     int completed = 0;
-    int current_time = 0;
+    int last_idx = -1;
+    int last_ended = 0;
+    long long current_time = 0;
+    int result = 0;
+    if (stream != 0 || band.nodes == NULL || band.started == NULL || group_root == NULL || group_level == NULL ||
+        free_groups == NULL || groups.items == NULL) {
+        completed = n;
+        result = -1;
+    }
+    
+    for (int i = 1; i <= n && completed < n; i++) {
+        band.nodes[i].priority = mix_hash((unsigned)i);
+        free_groups[i - 1] = n - i;
+    }
     
     while (completed < n) {
-        int best_idx = -1;
-        double highest_ratio = -1;
+        int i;
+        while ((i = arrivals_pop(&arrivals, current_time)) != -1) {
+            band.started[i] = 0;
+            lrjf_admit(&band, &groups, group_root, group_level, free_groups, &free_count, i);
+        }
         
-        for (int i = 0; i < n; i++) {
-            if (processes[i].completion_time == 0 && 
-                processes[i].arrival_time <= current_time) {
-                double waiting_time = current_time - processes[i].arrival_time;
-                double response_ratio = (waiting_time + processes[i].burst_time) / (double)processes[i].burst_time;
-                
-                if (response_ratio > highest_ratio) {
-                    highest_ratio = response_ratio;
-                    best_idx = i;
-                }
+        if (groups.size == 0) {
+            // No process arrived yet: the earliest arrival runs for one unit
+            if (last_idx != -1) {
+                counters->idle_transitions++;
             }
+            current_time = arrivals_next(&arrivals);
+            i = arrivals_pop(&arrivals, current_time);
+            current_time += run_counters_dispatch(counters, cost, last_idx, last_ended, i, 0);
+            last_idx = i;
+            if (state->response_time[i] == -1) {
+                state->response_time[i] = current_time - workload->arrival_time[i];
+            }
+            if (state->timeline != NULL) {
+                timeline_record(state->timeline, workload->pid[i], 0, current_time, current_time + 1);
+            }
+            state->remaining_time[i]--;
+            current_time++;
+            
+            last_ended = state->remaining_time[i] == 0;
+            if (last_ended) {
+                completed += arrivals_finish(&arrivals, i, current_time);
+            } else {
+                band.started[i] = 1;
+                lrjf_admit(&band, &groups, group_root, group_level, free_groups, &free_count, i);
+            }
+            continue;
         }
         
-        if (best_idx == -1) {
-            // No process arrived yet
-            for (int i = 0; i < n; i++) {
-                if (processes[i].completion_time == 0) {
-                    current_time = processes[i].arrival_time;
-                    best_idx = i;
-                    break;
+        // Top group, merged with any other group at the same level
+        int g = heap_pop(&groups).idx;
+        while (groups.size > 0 && -groups.items[0].key == group_level[g]) {
+            int other = heap_pop(&groups).idx;
+            group_root[g] = band_union(&band, group_root[g], group_root[other]);
+            free_groups[free_count++] = other;
+        }
+        
+        int root = group_root[g];
+        long long level = group_level[g];
+        int members = band.nodes[root].size;
+        int untouched = band.nodes[root].untouched;
+        long long until_arrival = arrivals_next(&arrivals) - current_time;
+        int first = band_first_untouched(&band, root) - 1;
+        int continues = first == last_idx && !last_ended;
+        
+        // Whole rounds cost the same each while every member has started and
+        // the round opens with a full switch, or the only member keeps the CPU
+        if (untouched == members && band.nodes[root].fresh == 0 && level > 1 &&
+            (members == 1 ? continues : first != last_idx && !last_ended)) {
+            // Whole rounds before the next arrival or the next lower group
+            long long lower_level = groups.size > 0 ? -groups.items[0].key : 0;
+            long long rounds = level - lower_level - 1;
+            long long round_time = members == 1 ? 1 : members * (band.step + band.warmup);
+            if (until_arrival / round_time < rounds) {
+                rounds = until_arrival / round_time;
+            }
+            if (rounds > 0) {
+                if (state->timeline != NULL) {
+                    if (members == 1) {
+                        timeline_record(state->timeline, workload->pid[first], 0, current_time,
+                                        current_time + rounds);
+                    }
+                    for (long long r = 0; members > 1 && r < rounds; r++) {
+                        int rank = 0;
+                        int cold_count = 0;
+                        band_record(&band, root, &rank, &cold_count,
+                                    current_time + r * round_time + cost->context_switch);
+                    }
                 }
+                group_level[g] = level - rounds;
+                current_time += rounds * round_time;
+                if (members > 1) {
+                    long long dispatches = rounds * members;
+                    counters->dispatches += dispatches;
+                    counters->context_switches += dispatches;
+                    counters->preemptions += dispatches;
+                    counters->overhead_time += dispatches * (cost->context_switch + cost->warmup);
+                    last_idx = band_last(&band, root) - 1;
+                }
+                heap_push(&groups, -group_level[g], g);
+                continue;
             }
         }
         
-        if (best_idx != -1) {
-            processes[best_idx].response_time = current_time - processes[best_idx].arrival_time;
-            current_time += processes[best_idx].burst_time;
-            processes[best_idx].completion_time = current_time;
-            completed++;
+        // Serve untouched members in index order while the next arrival is
+        // still to come. Credit is what the first member saves on a full
+        // switch, by keeping the CPU or by being the first to run.
+        int cold = band.started[first];
+        long long overhead = run_counters_dispatch(counters, cost, last_idx, last_ended, first, cold);
+        long long credit = cost->context_switch + cold * cost->warmup - overhead;
+        long long budget = until_arrival > LLONG_MAX - credit ? LLONG_MAX : until_arrival + credit;
+        int served = 1 + band_count_within(&band, root, untouched - 1, budget);
+        if (level == 1 && arrivals.position != NULL) {
+            served = 1;
         }
-    }
-}
-
-// LJF - Longest Job First (Non-preemptive)
-void ljf(Process *processes, int n) {
-    reset_processes(processes, n);
-    
-    int completed = 0;
-    int current_time = 0;
-    
-    while (completed < n) {
-        int longest_idx = -1;
-        int longest_time = -1;
+        int head, tail;
+        band_split_untouched(&band, root, served, &head, &tail);
         
-        for (int i = 0; i < n; i++) {
-            if (processes[i].completion_time == 0 && 
-                processes[i].arrival_time <= current_time &&
-                processes[i].burst_time > longest_time) {
-                longest_idx = i;
-                longest_time = processes[i].burst_time;
-            }
+        int started = served - band.nodes[head].fresh;
+        long long origin = current_time + cost->context_switch - credit;
+        long long elapsed = served * band.step + started * cost->warmup - credit;
+        if (served > 1) {
+            counters->dispatches += served - 1;
+            counters->context_switches += served - 1;
+            counters->preemptions += level > 1 ? served - 1 : 0;
+            counters->overhead_time += (served - 1) * cost->context_switch + (started - cold) * cost->warmup;
+        }
+        if (state->timeline != NULL) {
+            int rank = 0;
+            int cold_count = 0;
+            band_record(&band, head, &rank, &cold_count, origin);
         }
+        last_idx = band_last(&band, head) - 1;
+        last_ended = level == 1;
         
-        if (longest_idx == -1) {
-            // No process arrived yet
-            for (int i = 0; i < n; i++) {
-                if (processes[i].completion_time == 0) {
-                    current_time = processes[i].arrival_time;
-                    longest_idx = i;
-                    break;
-                }
+        if (level == 1) {
+            int rank = 0;
+            int cold_count = 0;
+            band_complete(&band, head, &rank, &cold_count, origin);
+            if (arrivals.position != NULL) {
+                completed += arrivals_finish(&arrivals, head - 1, current_time + elapsed);
+            } else {
+                completed += served;
             }
+            root = tail;
+        } else {
+            band_first_run(&band, head, 0, 0, origin);
+            band_apply(&band, head, 1);
+            root = band_merge(&band, head, tail);
         }
+        current_time += elapsed;
         
-        if (longest_idx != -1) {
-            processes[longest_idx].response_time = current_time - processes[longest_idx].arrival_time;
-            current_time += processes[longest_idx].burst_time;
-            processes[longest_idx].completion_time = current_time;
-            completed++;
+        if (served == untouched) {
+            // Round finished: every member is one unit lower and untouched again
+            level--;
+            band_apply(&band, root, 0);
+        }
+        
+        if (root) {
+            group_root[g] = root;
+            group_level[g] = level;
+            heap_push(&groups, -level, g);
+        } else {
+            free_groups[free_count++] = g;
         }
     }
+    
+    arrivals_free(&arrivals);
+    free(band.nodes);
+    free(band.started);
+    free(group_root);
+    free(group_level);
+    free(free_groups);
+    free(groups.items);
+    return result;
 }
 
-// LRJF - Longest Remaining Job First (Preemptive)
-void lrjf(Process *processes, int n) {
-    reset_processes(processes, n);
+int lrjf_run(const Workload *workload, RunState *state) {
+    ScheduleOptions options;
+    schedule_options_init(&options, 0);
+    return run_schedule_with(ALGORITHM_LRJF, workload, state, &options);
+}
+
+// CFS - Completely Fair Scheduler (Preemptive)
+//
+// Each process accumulates virtual runtime, its CPU time scaled by
+// NICE_0_WEIGHT / weight, and the ready process with the least vruntime runs
+// next. Ready processes sit in a red-black tree ordered by (vruntime, index).
+// A process runs for its weight's share of the scheduling period, the target
+// latency stretched to min_granularity per process when many are ready, and
+// never less than min_granularity. New processes start at the queue's
+// min_vruntime, and a process back from I/O keeps its vruntime unless that
+// fell behind min_vruntime while it slept. Preemption happens at slice ends
+// only (no wakeup preemption). The priority field is the nice level, clamped
+// to -20..19. A process that is still first after its slice keeps the CPU
+// without paying for a switch.
+
+#define CFS_NICE_0_WEIGHT 1024
+#define CFS_VRUNTIME_SHIFT 20       // vruntime unit: 2^-10 of nice-0 time
+
+static int cfs_simulate(const Workload *workload, RunState *state, long long target_latency,
+                        long long min_granularity, const SwitchCost *cost) {
+    int n = workload->n;
+    run_state_reset(state, workload);
+    
+    Arrivals arrivals;
+    int stream = arrivals_init(&arrivals, workload, state);
+    long long *vruntime = (long long *)malloc((n > 0 ? n : 1) * sizeof(long long));
+    RbTree ready;
+    if (stream != 0 || vruntime == NULL || rb_tree_init(&ready, n, vruntime) != 0) {
+        arrivals_free(&arrivals);
+        free(vruntime);
+        return -1;
+    }
     
+    long long latency_processes = target_latency / min_granularity;
+    long long min_vruntime = 0;
+    long long total_weight = 0;     // Of every ready process
     int completed = 0;
-    int current_time = 0;
+    int last_idx = -1;
+    int last_ended = 0;
+    long long current_time = 0;
     
     while (completed < n) {
-        int longest_idx = -1;
-        int longest_remaining = -1;
-        
-        for (int i = 0; i < n; i++) {
-            if (processes[i].remaining_time > 0 && 
-                processes[i].arrival_time <= current_time &&
-                processes[i].remaining_time > longest_remaining) {
-                longest_idx = i;
-                longest_remaining = processes[i].remaining_time;
+        int i;
+        while ((i = arrivals_pop(&arrivals, current_time)) != -1) {
+            if (state->response_time[i] == -1 || vruntime[i] < min_vruntime) {
+                vruntime[i] = min_vruntime;
             }
+            total_weight += nice_weight(workload->priority[i]);
+            rb_tree_insert(&ready, i);
         }
         
-        if (longest_idx == -1) {
+        int idx = rb_tree_first(&ready);
+        if (idx == -1) {
             // No process arrived yet
-            int min_arrival = INT_MAX;
-            for (int i = 0; i < n; i++) {
-                if (processes[i].remaining_time > 0 && 
-                    processes[i].arrival_time < min_arrival) {
-                    min_arrival = processes[i].arrival_time;
-                    longest_idx = i;
-                }
-            }
-            
-            if (longest_idx != -1) {
-                current_time = processes[longest_idx].arrival_time;
+            if (last_idx != -1) {
+                state->counters.idle_transitions++;
             }
+            current_time = arrivals_next(&arrivals);
+            continue;
+        }
+        rb_tree_remove(&ready, idx);
+        
+        long long weight = nice_weight(workload->priority[idx]);
+        long long period = ready.size + 1 > latency_processes ? (ready.size + 1) * min_granularity
+                                                              : target_latency;
+        long long slice = (long long)((__int128)period * weight / total_weight);
+        if (slice < min_granularity) {
+            slice = min_granularity;
+        }
+        long long run_time = state->remaining_time[idx] < slice ? state->remaining_time[idx] : slice;
+        
+        int cold = state->remaining_time[idx] < arrivals_burst(&arrivals, idx);
+        current_time += run_counters_dispatch(&state->counters, cost, last_idx, last_ended, idx, cold);
+        if (state->response_time[idx] == -1) {
+            state->response_time[idx] = current_time - workload->arrival_time[idx];
+        }
+        if (state->timeline != NULL) {
+            timeline_record(state->timeline, workload->pid[idx], 0, current_time, current_time + run_time);
+        }
+        current_time += run_time;
+        state->remaining_time[idx] -= run_time;
+        vruntime[idx] += (long long)(((__int128)run_time << CFS_VRUNTIME_SHIFT) / weight);
+        last_idx = idx;
+        last_ended = state->remaining_time[idx] == 0;
+        
+        if (state->remaining_time[idx] == 0) {
+            total_weight -= weight;
+            completed += arrivals_finish(&arrivals, idx, current_time);
+        } else {
+            rb_tree_insert(&ready, idx);
         }
         
-        if (longest_idx != -1) {
-            if (processes[longest_idx].response_time == -1) {
-                processes[longest_idx].response_time = current_time - processes[longest_idx].arrival_time;
+        // min_vruntime follows the smallest ready vruntime but never goes back
+        int first = rb_tree_first(&ready);
+        if (first != -1 && vruntime[first] > min_vruntime) {
+            min_vruntime = vruntime[first];
+        }
+    }
+    
+    arrivals_free(&arrivals);
+    rb_tree_free(&ready);
+    free(vruntime);
+    return 0;
+}
+
+int cfs_run(const Workload *workload, RunState *state, long long target_latency, long long min_granularity) {
+    ScheduleOptions options;
+    schedule_options_init(&options, 0);
+    options.target_latency = target_latency;
+    options.min_granularity = min_granularity;
+    return run_schedule_with(ALGORITHM_CFS, workload, state, &options);
+}
+
+const char *algorithm_name(int algorithm) {
+    static const char *const names[ALGORITHM_COUNT] = {
+        "First Come First Serve (FCFS)",
+        "Shortest Job First (SJF)",
+        "Shortest Remaining Job First (SRJF)",
+        "Round Robin (RR)",
+        "Priority Scheduling",
+        "Highest Response Ratio Next (HRRN)",
+        "Longest Job First (LJF)",
+        "Longest Remaining Job First (LRJF)",
+        "Completely Fair Scheduler (CFS)",
+        "Lottery Scheduling",
+        "Stride Scheduling",
+        "Preemptive Priority with Aging",
+        "Earliest Deadline First (EDF)",
+        "Rate Monotonic (RM)",
+        "Multi-Level Feedback Queue (MLFQ)"
+    };
+    if (algorithm < 1 || algorithm > ALGORITHM_COUNT) {
+        return NULL;
+    }
+    return names[algorithm - 1];
+}
+
+int algorithm_uses_quantum(int algorithm) {
+    return algorithm == ALGORITHM_ROUND_ROBIN || algorithm == ALGORITHM_LOTTERY || algorithm == ALGORITHM_STRIDE ||
+           algorithm == ALGORITHM_MLFQ;
+}
+
+void schedule_options_init(ScheduleOptions *options, long long time_quantum) {
+    options->time_quantum = time_quantum;
+    options->target_latency = CFS_TARGET_LATENCY;
+    options->min_granularity = CFS_MIN_GRANULARITY;
+    options->seed = LOTTERY_SEED;
+    options->aging_interval = AGING_INTERVAL;
+    options->mlfq_levels = MLFQ_LEVELS;
+    options->level_quanta = NULL;
+    options->boost_interval = MLFQ_BOOST_INTERVAL;
+    options->cost.context_switch = 0;
+    options->cost.warmup = 0;
+}
+
+// MLFQ checks its own settings, since its levels may not use the quantum
+static int options_valid(int algorithm, const ScheduleOptions *options) {
+    if (options->cost.context_switch < 0 || options->cost.warmup < 0) {
+        return 0;
+    }
+    switch (algorithm) {
+        case ALGORITHM_ROUND_ROBIN:
+        case ALGORITHM_LOTTERY:
+        case ALGORITHM_STRIDE:
+            return options->time_quantum > 0;
+        case ALGORITHM_CFS:
+            return options->min_granularity >= 1 && options->target_latency >= options->min_granularity;
+        case ALGORITHM_PRIORITY_AGING:
+            return options->aging_interval >= 0;
+        default:
+            return 1;
+    }
+}
+
+int run_schedule_with(int algorithm, const Workload *workload, RunState *state, const ScheduleOptions *options) {
+    const SwitchCost *cost = &options->cost;
+    if (algorithm_name(algorithm) == NULL) {
+        return SCHEDULE_ERR_ALGORITHM;
+    }
+    if (!options_valid(algorithm, options)) {
+        run_state_reset(state, workload);
+        return SCHEDULE_ERR_CONFIG;
+    }
+    // A hand-built workload may not have been checked, and a burst of 0
+    // would never complete
+    if (workload_check(workload) != WORKLOAD_OK) {
+        run_state_reset(state, workload);
+        return SCHEDULE_ERR_WORKLOAD;
+    }
+    
+    int result = 0;
+    switch (algorithm) {
+        case ALGORITHM_FCFS: result = run_policy(READY_FIFO, workload, state, options); break;
+        case ALGORITHM_SJF: result = run_policy(READY_SHORTEST, workload, state, options); break;
+        case ALGORITHM_SRJF: result = run_policy(READY_REMAINING, workload, state, options); break;
+        case ALGORITHM_ROUND_ROBIN: result = run_policy(READY_ROUND_ROBIN, workload, state, options); break;
+        case ALGORITHM_PRIORITY: result = run_policy(READY_PRIORITY, workload, state, options); break;
+        case ALGORITHM_HRRN: result = run_policy(READY_RATIO, workload, state, options); break;
+        case ALGORITHM_LJF: result = run_policy(READY_LONGEST, workload, state, options); break;
+        case ALGORITHM_LRJF: result = lrjf_simulate(workload, state, cost); break;
+        case ALGORITHM_CFS:
+            result = cfs_simulate(workload, state, options->target_latency, options->min_granularity, cost);
+            break;
+        case ALGORITHM_LOTTERY: result = run_policy(READY_LOTTERY, workload, state, options); break;
+        case ALGORITHM_STRIDE: result = run_policy(READY_STRIDE, workload, state, options); break;
+        case ALGORITHM_PRIORITY_AGING:
+            result = priority_preemptive_simulate(workload, state, options->aging_interval, cost);
+            break;
+        case ALGORITHM_EDF: result = run_policy(READY_DEADLINE, workload, state, options); break;
+        case ALGORITHM_RM: result = run_policy(READY_RATE, workload, state, options); break;
+        case ALGORITHM_MLFQ: {
+            MlfqConfig config;
+            mlfq_config_from_options(&config, options);
+            int mlfq_result = mlfq_run_with(workload, state, &config, NULL);
+            if (mlfq_result == MLFQ_ERR_CONFIG) {
+                return SCHEDULE_ERR_CONFIG;
             }
-            
-            processes[longest_idx].remaining_time--;
-            current_time++;
-            
-            if (processes[longest_idx].remaining_time == 0) {
-                processes[longest_idx].completion_time = current_time;
-                completed++;
+            if (mlfq_result == MLFQ_ERR_WORKLOAD) {
+                return SCHEDULE_ERR_WORKLOAD;
             }
+            result = mlfq_result == MLFQ_OK ? 0 : -1;
+            break;
         }
     }
+    if (result != 0) {
+        run_state_reset(state, workload);
+        return SCHEDULE_ERR_MEMORY;
+    }
+    return SCHEDULE_OK;
+}
+
+int run_schedule(int algorithm, const Workload *workload, RunState *state, long long time_quantum) {
+    ScheduleOptions options;
+    schedule_options_init(&options, time_quantum);
+    return run_schedule_with(algorithm, workload, state, &options);
+}
+
+const char *schedule_error_string(int error) {
+    switch (error) {
+        case SCHEDULE_OK: return "no error";
+        case SCHEDULE_ERR_MEMORY: return "out of memory";
+        case SCHEDULE_ERR_CONFIG: return "invalid quantum, CFS latency, aging interval, MLFQ levels or switch cost";
+        case SCHEDULE_ERR_ALGORITHM: return "unknown algorithm";
+        case SCHEDULE_ERR_WORKLOAD: return "negative arrival, deadline or period, or non-positive burst";
+        default: return "unknown error";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Process array entry points: run the column algorithms on a copy of the
+// array and write the results back
+// ---------------------------------------------------------------------------
+
+static int begin_process_run(Process *processes, int n, Workload *workload, RunState *state) {
+    int result = workload_from_processes(workload, processes, n);
+    if (result != WORKLOAD_OK) {
+        return result == WORKLOAD_ERR_INVALID ? SCHEDULE_ERR_WORKLOAD : SCHEDULE_ERR_MEMORY;
+    }
+    if (run_state_init(state, n) != 0) {
+        workload_free(workload);
+        return SCHEDULE_ERR_MEMORY;
+    }
+    return SCHEDULE_OK;
+}
+
+// Copies the results back when the run succeeded; returns its result
+static int end_process_run(Process *processes, int n, Workload *workload, RunState *state, int result) {
+    for (int i = 0; i < n && result == SCHEDULE_OK; i++) {
+        processes[i].remaining_time = state->remaining_time[i];
+        processes[i].completion_time = state->completion_time[i];
+        processes[i].turnaround_time = 0;
+        processes[i].waiting_time = 0;
+        processes[i].response_time = state->response_time[i];
+    }
+    run_state_free(state);
+    workload_free(workload);
+    return result;
+}
+
+int fcfs(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = fcfs_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int round_robin(Process *processes, int n, long long time_quantum) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = round_robin_run(&workload, &state, time_quantum);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int sjf(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = sjf_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int srjf(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = srjf_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int priority_scheduling(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = priority_scheduling_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int hrrn(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = hrrn_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int ljf(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = ljf_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int lrjf(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = lrjf_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int cfs(Process *processes, int n, long long target_latency, long long min_granularity) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = cfs_run(&workload, &state, target_latency, min_granularity);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int lottery(Process *processes, int n, long long time_quantum, unsigned long long seed) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = lottery_run(&workload, &state, time_quantum, seed);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int stride(Process *processes, int n, long long time_quantum) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = stride_run(&workload, &state, time_quantum);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int priority_preemptive(Process *processes, int n, long long aging_interval) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = priority_preemptive_run(&workload, &state, aging_interval);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int edf(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = edf_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int rate_monotonic(Process *processes, int n) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = rate_monotonic_run(&workload, &state);
+    return end_process_run(processes, n, &workload, &state, result);
+}
+
+int mlfq(Process *processes, int n, long long time_quantum) {
+    Workload workload;
+    RunState state;
+    int result = begin_process_run(processes, n, &workload, &state);
+    if (result != SCHEDULE_OK) return result;
+    result = mlfq_run(&workload, &state, time_quantum);
+    return end_process_run(processes, n, &workload, &state, result);
 }
@@ -1,45 +1,324 @@
 #ifndef SCHEDULING_H
 #define SCHEDULING_H
 
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-#define MAX_PROCESSES 50
+#include <limits.h>
+#include "arena.h"
+#include "histogram.h"
+#include "timeline.h"
 
 typedef struct {
     int pid;                    // Process ID
-    int arrival_time;          // Arrival time at CPU
-    int burst_time;            // Original burst time
-    int remaining_time;        // Remaining burst time (for preemptive)
+    long long arrival_time;    // Arrival time at CPU
+    long long burst_time;      // Original burst time; the CPU total with a burst sequence
+    long long remaining_time;  // Remaining burst time (for preemptive)
     int priority;              // Priority (lower value = higher priority)
-    int completion_time;       // Time when process completes
-    int turnaround_time;       // completion_time - arrival_time
-    int waiting_time;          // turnaround_time - burst_time
-    int response_time;         // First time process gets CPU
+    long long completion_time; // Time when process completes
+    long long turnaround_time; // completion_time - arrival_time
+    long long waiting_time;    // turnaround_time - burst_time
+    long long response_time;   // First time process gets CPU
+    long long deadline;        // Relative deadline, 0 for none
+    long long period;          // Release period, 0 for a one-shot job
+    const long long *bursts;   // CPU and I/O bursts, alternating from a CPU burst to a CPU burst; NULL for one CPU burst
+    int burst_count;           // Length of bursts, 0 without a sequence
 } Process;
 
+// Growable process array; workloads are sized at runtime
+typedef struct {
+    Process *items;
+    int count;
+    int capacity;
+    Arena bursts;               // Backs the burst sequences of the processes in the list
+} ProcessList;
+
+// Read-only workload in column form. The columns may point into a read-only
+// mapping of a binary workload file (see workload.h) or into owned memory.
+typedef struct {
+    int n;
+    const int *pid;
+    const long long *arrival_time;
+    const long long *burst_time;
+    const int *priority;
+    const long long *deadline;  // NULL when no process has a deadline or period
+    const long long *period;    // NULL exactly when deadline is
+    const long long *bursts;    // Every process's burst sequence, back to back; NULL when each has one CPU burst
+    const long long *burst_start;   // n + 1 offsets: process i's sequence is bursts[burst_start[i]..burst_start[i + 1])
+    void *storage;              // Memory or mapping that backs the columns
+    size_t mapped_size;         // Length of the mapping, 0 for heap memory
+    int *arrival_order;         // Indices by (arrival_time, index), see workload_index()
+} Workload;
+
+// A periodic process's deadline defaults to its period (implicit deadline)
+static inline long long workload_deadline(const Workload *workload, int i) {
+    if (workload->deadline == NULL) {
+        return 0;
+    }
+    return workload->deadline[i] > 0 ? workload->deadline[i] : workload->period[i];
+}
+
+// Rate Monotonic rank: the period, else the relative deadline, 0 for none
+static inline long long workload_rate(const Workload *workload, int i) {
+    if (workload->deadline == NULL) {
+        return 0;
+    }
+    return workload->period[i] > 0 ? workload->period[i] : workload->deadline[i];
+}
+
+// Total I/O time between process i's CPU bursts
+static inline long long workload_io_time(const Workload *workload, int i) {
+    long long io_time = 0;
+    if (workload->bursts != NULL) {
+        for (long long b = workload->burst_start[i] + 1; b < workload->burst_start[i + 1]; b += 2) {
+            io_time += workload->bursts[b];
+        }
+    }
+    return io_time;
+}
+
+// A job without a deadline is treated as due this long after its release,
+// so it runs after every job with one, first come first served
+#define DEADLINE_NONE (1LL << 62)
+
+// Absolute deadline of a job released at release, saturating at LLONG_MAX
+static inline long long deadline_key(long long release, long long relative_deadline) {
+    if (relative_deadline <= 0) {
+        relative_deadline = DEADLINE_NONE;
+    }
+    return release > LLONG_MAX - relative_deadline ? LLONG_MAX : release + relative_deadline;
+}
+
+// Time lost each time the CPU changes hands, 0 for none. A process that
+// resumes a CPU burst it was preempted from also refills its cache first.
+typedef struct {
+    long long context_switch;   // Dispatching a different process than the one that ran last
+    long long warmup;           // Resuming a CPU burst after a preemption
+} SwitchCost;
+
+// What the CPU did during a run, counted by every algorithm
+typedef struct {
+    long long dispatches;       // A process got the CPU, not counting one that kept it
+    long long preemptions;      // The process that had the CPU lost it with CPU time left
+    long long context_switches; // Dispatches of a different process than the last
+    long long idle_transitions; // The CPU went idle with processes still to come
+    long long overhead_time;    // Time lost to context switches and cache warmup
+} RunCounters;
+
+// Records that process i gets the CPU after last (-1 for none) had it, and
+// returns the overhead to charge before i does any work. last_ended: last
+// gave up the CPU at the end of a CPU burst. cold: i already ran part of its
+// current CPU burst. A process that keeps the CPU is not dispatched again.
+static inline long long run_counters_dispatch(RunCounters *counters, const SwitchCost *cost, int last,
+                                              int last_ended, int i, int cold) {
+    if (i == last && !last_ended) {
+        return 0;
+    }
+    long long overhead = 0;
+    counters->dispatches++;
+    if (last != -1 && i != last) {
+        counters->context_switches++;
+        counters->preemptions += !last_ended;
+        overhead = cost->context_switch;
+    }
+    if (cold) {
+        overhead += cost->warmup;
+    }
+    counters->overhead_time += overhead;
+    return overhead;
+}
+
+// Mutable per-run results, kept apart so the workload itself stays read-only
+typedef struct {
+    int n;
+    long long *remaining_time;  // Of the current CPU burst with burst sequences
+    long long *completion_time; // 0 until the process completes
+    long long *response_time;   // -1 until the process first runs, after any switch overhead
+    long long io_busy_time;     // Time at least one process was in an I/O burst
+    long long io_overlap_time;  // Part of io_busy_time the CPU spent running a process
+    RunCounters counters;
+    Timeline *timeline;         // Where the run records its segments, NULL for none; cleared by run_state_reset()
+} RunState;
+
+// Tail of a latency distribution, each within 0.1% (see histogram.h)
+typedef struct {
+    long long p50;
+    long long p95;
+    long long p99;
+    long long max;
+} LatencySummary;
+
 typedef struct {
-    float avg_waiting_time;
-    float avg_turnaround_time;
-    float avg_response_time;
-    float cpu_utilization;
+    double avg_waiting_time;
+    double avg_turnaround_time;
+    double avg_response_time;
+    double cpu_utilization;     // Busy time as a percentage of total time
+    LatencySummary waiting;
+    LatencySummary turnaround;
+    LatencySummary response;
+    long long busy_time;        // Sum of bursts
+    long long idle_time;        // total_time - busy_time - counters.overhead_time
+    long long io_time;          // Sum of I/O bursts; waiting time excludes it
+    double avg_io_time;
+    long long io_busy_time;     // See RunState
+    long long io_overlap_time;
+    RunCounters counters;
 } Metrics;
 
+// One-pass metrics: feed every completed process, then summarize at any
+// point. Sums use long double so averages stay exact well past 2^53.
+typedef struct {
+    Histogram waiting;
+    Histogram turnaround;
+    Histogram response;
+    long long count;
+    long double total_waiting;
+    long double total_turnaround;
+    long double total_response;
+    long long busy_time;
+    long long io_time;
+    int failed;                 // A histogram could not grow
+} MetricsAccumulator;
+
+// Process list management
+void process_list_init(ProcessList *list);
+int process_list_reserve(ProcessList *list, int capacity);
+Process *process_list_append(ProcessList *list);
+const long long *process_list_copy_bursts(ProcessList *list, const long long *bursts, int count);
+void process_list_free(ProcessList *list);
+
+// Run state management. run_state_init() allocates the result arrays;
+// run_state_bind() uses n entries of each of the caller's arrays instead,
+// and such a state is never passed to run_state_free().
+int run_state_init(RunState *state, int n);
+void run_state_bind(RunState *state, int n, long long *remaining_time, long long *completion_time,
+                    long long *response_time);
+void run_state_reset(RunState *state, const Workload *workload);
+void run_state_free(RunState *state);
+
 // Function declarations
-void input_processes(Process *processes, int *n);
-void display_processes(Process *processes, int n);
 void reset_processes(Process *processes, int n);
-void calculate_metrics(Process *processes, int n, int total_time, Metrics *metrics);
-
-// Scheduling algorithms
-void fcfs(Process *processes, int n);
-void sjf(Process *processes, int n);
-void srjf(Process *processes, int n);
-void round_robin(Process *processes, int n, int time_quantum);
-void priority_scheduling(Process *processes, int n);
-void hrrn(Process *processes, int n);
-void ljf(Process *processes, int n);
-void lrjf(Process *processes, int n);
+int calculate_metrics(Process *processes, int n, long long total_time, Metrics *metrics);
+long long run_total_time(const RunState *state);
+void metrics_accumulator_init(MetricsAccumulator *acc);
+void metrics_accumulator_add(MetricsAccumulator *acc, long long turnaround_time, long long burst_time,
+                             long long io_time, long long response_time);
+int metrics_accumulator_summary(const MetricsAccumulator *acc, long long total_time, Metrics *metrics);
+void metrics_set_counters(Metrics *metrics, const RunCounters *counters);
+void metrics_accumulator_free(MetricsAccumulator *acc);
+int calculate_run_metrics(const Workload *workload, const RunState *state, long long total_time, Metrics *metrics);
+
+// Scheduling algorithms over a process array, with the results written back
+// into it. Each returns a SCHEDULE_ code and leaves the array as it was on
+// an error: SCHEDULE_ERR_WORKLOAD for a negative arrival or a burst below 1,
+// SCHEDULE_ERR_CONFIG for a quantum below 1, for instance.
+int fcfs(Process *processes, int n);
+int sjf(Process *processes, int n);
+int srjf(Process *processes, int n);
+int round_robin(Process *processes, int n, long long time_quantum);
+int priority_scheduling(Process *processes, int n);
+int hrrn(Process *processes, int n);
+int ljf(Process *processes, int n);
+int lrjf(Process *processes, int n);
+int cfs(Process *processes, int n, long long target_latency, long long min_granularity);
+int lottery(Process *processes, int n, long long time_quantum, unsigned long long seed);
+int stride(Process *processes, int n, long long time_quantum);
+int priority_preemptive(Process *processes, int n, long long aging_interval);
+int edf(Process *processes, int n);
+int rate_monotonic(Process *processes, int n);
+int mlfq(Process *processes, int n, long long time_quantum);
+
+// Scheduling algorithms over a read-only workload. Switches cost nothing
+// here; run_schedule_with() takes a SwitchCost. Each returns a SCHEDULE_
+// code, as run_schedule_with() does.
+int fcfs_run(const Workload *workload, RunState *state);
+int sjf_run(const Workload *workload, RunState *state);
+int srjf_run(const Workload *workload, RunState *state);
+int round_robin_run(const Workload *workload, RunState *state, long long time_quantum);
+int priority_scheduling_run(const Workload *workload, RunState *state);
+int lottery_run(const Workload *workload, RunState *state, long long time_quantum, unsigned long long seed);
+int stride_run(const Workload *workload, RunState *state, long long time_quantum);
+int priority_preemptive_run(const Workload *workload, RunState *state, long long aging_interval);
+int hrrn_run(const Workload *workload, RunState *state);
+int ljf_run(const Workload *workload, RunState *state);
+int lrjf_run(const Workload *workload, RunState *state);
+int cfs_run(const Workload *workload, RunState *state, long long target_latency, long long min_granularity);
+int edf_run(const Workload *workload, RunState *state);
+int rate_monotonic_run(const Workload *workload, RunState *state);
+int mlfq_run(const Workload *workload, RunState *state, long long time_quantum);
+
+// CFS defaults, in time units (the Linux 6:0.75 ratio). run_schedule() uses
+// these; the target latency must be at least the minimum granularity.
+#define CFS_TARGET_LATENCY 24
+#define CFS_MIN_GRANULARITY 3
+
+// Lottery seed used by run_schedule()
+#define LOTTERY_SEED 1
+
+// Time a process waits per priority level gained, used by run_schedule()
+#define AGING_INTERVAL 100
+
+// MLFQ defaults: levels, with quanta doubling from the time quantum, and
+// the time between boosts to the top level
+#define MLFQ_LEVELS 3
+#define MLFQ_BOOST_INTERVAL 1000
+
+// Round Robin with caller-provided scratch: queue and batch hold n ints each.
+// Returns a SCHEDULE_ code, SCHEDULE_ERR_WORKLOAD as run_schedule_with()
+// does; only burst sequences or a workload without its arrival index make
+// it allocate.
+int round_robin_run_with(const Workload *workload, RunState *state, long long time_quantum,
+                         const SwitchCost *cost, int *queue, int *batch);
+
+// Algorithms by menu number
+#define ALGORITHM_FCFS 1
+#define ALGORITHM_SJF 2
+#define ALGORITHM_SRJF 3
+#define ALGORITHM_ROUND_ROBIN 4
+#define ALGORITHM_PRIORITY 5
+#define ALGORITHM_HRRN 6
+#define ALGORITHM_LJF 7
+#define ALGORITHM_LRJF 8
+#define ALGORITHM_CFS 9
+#define ALGORITHM_LOTTERY 10
+#define ALGORITHM_STRIDE 11
+#define ALGORITHM_PRIORITY_AGING 12
+#define ALGORITHM_EDF 13
+#define ALGORITHM_RM 14
+#define ALGORITHM_MLFQ 15
+#define ALGORITHM_COUNT 15
+const char *algorithm_name(int algorithm);
+
+// Round Robin, Lottery, Stride and MLFQ run in time quanta
+int algorithm_uses_quantum(int algorithm);
+
+// Settings for the algorithms that take any
+typedef struct {
+    long long time_quantum;
+    long long target_latency;       // CFS
+    long long min_granularity;      // CFS
+    unsigned long long seed;        // Lottery
+    long long aging_interval;       // Preemptive Priority; 0 disables aging
+    int mlfq_levels;
+    const long long *level_quanta;  // MLFQ: one per level, or NULL to double from the quantum
+    long long boost_interval;       // MLFQ; 0 disables boosts
+    SwitchCost cost;                // Every algorithm
+} ScheduleOptions;
+
+// Defaults for everything but the quantum; switches cost nothing
+void schedule_options_init(ScheduleOptions *options, long long time_quantum);
+
+#define SCHEDULE_OK 0
+#define SCHEDULE_ERR_MEMORY -1
+#define SCHEDULE_ERR_CONFIG -2
+#define SCHEDULE_ERR_ALGORITHM -3
+#define SCHEDULE_ERR_WORKLOAD -4        // Fails workload_check()
+
+// Runs an algorithm by menu number, charging options->cost at every switch.
+// Returns a SCHEDULE_ code; on an error the state is left as reset. Runs
+// share nothing but the read-only workload, so any number can go at once
+// on different states once the workload's arrival index is built.
+int run_schedule_with(int algorithm, const Workload *workload, RunState *state, const ScheduleOptions *options);
+int run_schedule(int algorithm, const Workload *workload, RunState *state, long long time_quantum);
+const char *schedule_error_string(int error);
 
 #endif
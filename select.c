@@ -0,0 +1,483 @@
+#include "select.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SELECT_X86 1
+#include <immintrin.h>
+#endif
+
+typedef __int128 wide;
+
+// What a min scan orders by: SJF the burst, Priority the priority value, and
+// LJF the negated burst, so every scan looks for the smallest key
+typedef enum {
+    KEY_BURST,
+    KEY_PRIORITY,
+    KEY_LONGEST
+} ScanKey;
+
+// The columns a scan reads
+typedef struct {
+    int n;
+    const long long *arrival;
+    const long long *completion;
+    const long long *burst;
+    const int *priority;
+    long long now;
+} Scan;
+
+static inline int scan_ready(const Scan *s, int i) {
+    return s->arrival[i] <= s->now && s->completion[i] == 0;
+}
+
+static inline long long scan_key(const Scan *s, ScanKey key, int i) {
+    switch (key) {
+        case KEY_BURST: return s->burst[i];
+        case KEY_PRIORITY: return s->priority[i];
+        default: return -s->burst[i];
+    }
+}
+
+// Continues a min scan at start, where best (-1 for none) won everything
+// before it. Indices only go up, so an equal key keeps the earlier winner.
+static int key_min_from(const Scan *s, ScanKey key, int start, int best) {
+    long long best_key = best >= 0 ? scan_key(s, key, best) : 0;
+    
+    for (int i = start; i < s->n; i++) {
+        if (scan_ready(s, i)) {
+            long long k = scan_key(s, key, i);
+            if (best < 0 || k < best_key) {
+                best = i;
+                best_key = k;
+            }
+        }
+    }
+    return best;
+}
+
+// Process i's response ratio is above best's (always, when best is -1).
+// Comparing wait / burst by cross-multiplication is exact.
+static inline int ratio_above(const Scan *s, int i, int best) {
+    if (best < 0) {
+        return 1;
+    }
+    return (wide)(s->now - s->arrival[i]) * s->burst[best] >
+           (wide)(s->now - s->arrival[best]) * s->burst[i];
+}
+
+static int ratio_max_from(const Scan *s, int start, int best) {
+    for (int i = start; i < s->n; i++) {
+        if (scan_ready(s, i) && ratio_above(s, i, best)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+#ifdef SELECT_X86
+
+// Best (key, index) of the per-lane winners; a lane without one holds -1
+static int reduce_key_lanes(const long long *keys, const long long *index, int lanes) {
+    int best = -1;
+    long long best_key = 0;
+    
+    for (int lane = 0; lane < lanes; lane++) {
+        if (index[lane] >= 0 && (best < 0 || keys[lane] < best_key ||
+                                 (keys[lane] == best_key && index[lane] < best))) {
+            best = (int)index[lane];
+            best_key = keys[lane];
+        }
+    }
+    return best;
+}
+
+// Lane holding the highest ratio when no other lane reaches it and no
+// process tied its lane's best on the way, or -1 when the winner needs the
+// exact pass (or there is none)
+static int reduce_ratio_lanes(const double *ratios, const long long *index, int tie_lanes, int lanes,
+                              double *top) {
+    int winner = -1;
+    int count = 0;
+    *top = -1;
+    
+    for (int lane = 0; lane < lanes; lane++) {
+        if (ratios[lane] > *top) {
+            *top = ratios[lane];
+        }
+    }
+    for (int lane = 0; lane < lanes; lane++) {
+        if (*top >= 0 && ratios[lane] == *top) {
+            winner = lane;
+            count++;
+        }
+    }
+    if (count != 1 || (tie_lanes >> winner & 1)) {
+        return -1;
+    }
+    return (int)index[winner];
+}
+
+// Bits 52 and up of a wait or a burst: the conversions below need them clear
+#define RATIO_RANGE ((long long)(~0ULL << 52))
+
+// ---------------------------------------------------------------------------
+// AVX2: four processes per step
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static inline __m256i load_key_avx2(const Scan *s, ScanKey key, int i) {
+    switch (key) {
+        case KEY_BURST:
+            return _mm256_loadu_si256((const __m256i *)(s->burst + i));
+        case KEY_PRIORITY:
+            return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(s->priority + i)));
+        default:
+            return _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_loadu_si256((const __m256i *)(s->burst + i)));
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i ready_avx2(const Scan *s, int i, __m256i now) {
+    __m256i late = _mm256_cmpgt_epi64(_mm256_loadu_si256((const __m256i *)(s->arrival + i)), now);
+    __m256i open = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(s->completion + i)),
+                                      _mm256_setzero_si256());
+    return _mm256_andnot_si256(late, open);
+}
+
+// Exact for 0 <= x < 2^52: x becomes the low mantissa bits of 2^52 + x
+__attribute__((target("avx2")))
+static inline __m256d to_double_avx2(__m256i x) {
+    __m256i biased = _mm256_or_si256(x, _mm256_set1_epi64x(0x4330000000000000LL));
+    return _mm256_sub_pd(_mm256_castsi256_pd(biased), _mm256_set1_pd(4503599627370496.0));
+}
+
+// wait / burst of processes i..i+3, -1 where not ready. Ready lanes' waits
+// and bursts are ORed into range.
+__attribute__((target("avx2")))
+static inline __m256d ratio_avx2(const Scan *s, int i, __m256i now, __m256i ready, __m256i *range) {
+    __m256i wait = _mm256_sub_epi64(now, _mm256_loadu_si256((const __m256i *)(s->arrival + i)));
+    __m256i burst = _mm256_loadu_si256((const __m256i *)(s->burst + i));
+    *range = _mm256_or_si256(*range, _mm256_and_si256(ready, _mm256_or_si256(wait, burst)));
+    __m256d ratio = _mm256_div_pd(to_double_avx2(wait), to_double_avx2(burst));
+    return _mm256_blendv_pd(_mm256_set1_pd(-1.0), ratio, _mm256_castsi256_pd(ready));
+}
+
+__attribute__((target("avx2")))
+static int key_min_avx2(const Scan *s, ScanKey key) {
+    __m256i now = _mm256_set1_epi64x(s->now);
+    __m256i none = _mm256_set1_epi64x(-1);
+    __m256i best_key = _mm256_setzero_si256();
+    __m256i best_index = none;
+    __m256i lane = _mm256_set_epi64x(3, 2, 1, 0);
+    int i = 0;
+    
+    for (; i + 4 <= s->n; i += 4) {
+        __m256i ready = ready_avx2(s, i, now);
+        if (_mm256_testz_si256(ready, ready)) {
+            continue;
+        }
+        __m256i k = load_key_avx2(s, key, i);
+        __m256i empty = _mm256_cmpeq_epi64(best_index, none);
+        __m256i better = _mm256_and_si256(ready, _mm256_or_si256(empty, _mm256_cmpgt_epi64(best_key, k)));
+        best_key = _mm256_blendv_epi8(best_key, k, better);
+        best_index = _mm256_blendv_epi8(best_index, _mm256_add_epi64(_mm256_set1_epi64x(i), lane), better);
+    }
+    
+    long long keys[4];
+    long long lanes[4];
+    _mm256_storeu_si256((__m256i *)keys, best_key);
+    _mm256_storeu_si256((__m256i *)lanes, best_index);
+    return key_min_from(s, key, i, reduce_key_lanes(keys, lanes, 4));
+}
+
+// Exact winner among processes 0..end-1 whose double ratio is top
+__attribute__((target("avx2")))
+static int ratio_ties_avx2(const Scan *s, int end, double top) {
+    __m256i now = _mm256_set1_epi64x(s->now);
+    __m256d target = _mm256_set1_pd(top);
+    __m256i range = _mm256_setzero_si256();
+    int best = -1;
+    
+    for (int i = 0; i < end; i += 4) {
+        __m256i ready = ready_avx2(s, i, now);
+        if (_mm256_testz_si256(ready, ready)) {
+            continue;
+        }
+        int equal = _mm256_movemask_pd(_mm256_cmp_pd(ratio_avx2(s, i, now, ready, &range), target, _CMP_EQ_OQ));
+        for (int lane = 0; lane < 4; lane++) {
+            if ((equal >> lane & 1) && ratio_above(s, i + lane, best)) {
+                best = i + lane;
+            }
+        }
+    }
+    return best;
+}
+
+// Each lane keeps the first process with its highest double ratio. Distinct
+// exact ratios can round to the same double, so if the top is shared, or a
+// lane saw its best equalled, a second pass settles the processes at the top
+// exactly.
+__attribute__((target("avx2")))
+static int ratio_max_avx2(const Scan *s) {
+    __m256i now = _mm256_set1_epi64x(s->now);
+    __m256d best = _mm256_set1_pd(-1.0);
+    __m256i best_index = _mm256_set1_epi64x(-1);
+    __m256d tied = _mm256_setzero_pd();
+    __m256i range = _mm256_setzero_si256();
+    __m256i lane = _mm256_set_epi64x(3, 2, 1, 0);
+    int i = 0;
+    
+    for (; i + 4 <= s->n; i += 4) {
+        __m256i ready = ready_avx2(s, i, now);
+        if (_mm256_testz_si256(ready, ready)) {
+            continue;
+        }
+        __m256d ratio = ratio_avx2(s, i, now, ready, &range);
+        __m256d equal = _mm256_and_pd(_mm256_castsi256_pd(ready), _mm256_cmp_pd(ratio, best, _CMP_EQ_OQ));
+        __m256d above = _mm256_cmp_pd(ratio, best, _CMP_GT_OQ);
+        tied = _mm256_or_pd(tied, equal);
+        best = _mm256_blendv_pd(best, ratio, above);
+        best_index = _mm256_blendv_epi8(best_index, _mm256_add_epi64(_mm256_set1_epi64x(i), lane),
+                                        _mm256_castpd_si256(above));
+    }
+    if (!_mm256_testz_si256(range, _mm256_set1_epi64x(RATIO_RANGE))) {
+        return ratio_max_from(s, 0, -1);
+    }
+    
+    double ratios[4];
+    long long lanes[4];
+    double top;
+    _mm256_storeu_pd(ratios, best);
+    _mm256_storeu_si256((__m256i *)lanes, best_index);
+    int winner = reduce_ratio_lanes(ratios, lanes, _mm256_movemask_pd(tied), 4, &top);
+    if (winner < 0 && top >= 0) {
+        winner = ratio_ties_avx2(s, i, top);
+    }
+    return ratio_max_from(s, i, winner);
+}
+
+// ---------------------------------------------------------------------------
+// SSE4.2: two processes per step
+// ---------------------------------------------------------------------------
+
+__attribute__((target("sse4.2")))
+static inline __m128i load_key_sse42(const Scan *s, ScanKey key, int i) {
+    switch (key) {
+        case KEY_BURST:
+            return _mm_loadu_si128((const __m128i *)(s->burst + i));
+        case KEY_PRIORITY:
+            return _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i *)(s->priority + i)));
+        default:
+            return _mm_sub_epi64(_mm_setzero_si128(), _mm_loadu_si128((const __m128i *)(s->burst + i)));
+    }
+}
+
+__attribute__((target("sse4.2")))
+static inline __m128i ready_sse42(const Scan *s, int i, __m128i now) {
+    __m128i late = _mm_cmpgt_epi64(_mm_loadu_si128((const __m128i *)(s->arrival + i)), now);
+    __m128i open = _mm_cmpeq_epi64(_mm_loadu_si128((const __m128i *)(s->completion + i)), _mm_setzero_si128());
+    return _mm_andnot_si128(late, open);
+}
+
+__attribute__((target("sse4.2")))
+static inline __m128d to_double_sse42(__m128i x) {
+    __m128i biased = _mm_or_si128(x, _mm_set1_epi64x(0x4330000000000000LL));
+    return _mm_sub_pd(_mm_castsi128_pd(biased), _mm_set1_pd(4503599627370496.0));
+}
+
+__attribute__((target("sse4.2")))
+static inline __m128d ratio_sse42(const Scan *s, int i, __m128i now, __m128i ready, __m128i *range) {
+    __m128i wait = _mm_sub_epi64(now, _mm_loadu_si128((const __m128i *)(s->arrival + i)));
+    __m128i burst = _mm_loadu_si128((const __m128i *)(s->burst + i));
+    *range = _mm_or_si128(*range, _mm_and_si128(ready, _mm_or_si128(wait, burst)));
+    __m128d ratio = _mm_div_pd(to_double_sse42(wait), to_double_sse42(burst));
+    return _mm_blendv_pd(_mm_set1_pd(-1.0), ratio, _mm_castsi128_pd(ready));
+}
+
+__attribute__((target("sse4.2")))
+static int key_min_sse42(const Scan *s, ScanKey key) {
+    __m128i now = _mm_set1_epi64x(s->now);
+    __m128i none = _mm_set1_epi64x(-1);
+    __m128i best_key = _mm_setzero_si128();
+    __m128i best_index = none;
+    __m128i lane = _mm_set_epi64x(1, 0);
+    int i = 0;
+    
+    for (; i + 2 <= s->n; i += 2) {
+        __m128i ready = ready_sse42(s, i, now);
+        if (_mm_testz_si128(ready, ready)) {
+            continue;
+        }
+        __m128i k = load_key_sse42(s, key, i);
+        __m128i empty = _mm_cmpeq_epi64(best_index, none);
+        __m128i better = _mm_and_si128(ready, _mm_or_si128(empty, _mm_cmpgt_epi64(best_key, k)));
+        best_key = _mm_blendv_epi8(best_key, k, better);
+        best_index = _mm_blendv_epi8(best_index, _mm_add_epi64(_mm_set1_epi64x(i), lane), better);
+    }
+    
+    long long keys[2];
+    long long lanes[2];
+    _mm_storeu_si128((__m128i *)keys, best_key);
+    _mm_storeu_si128((__m128i *)lanes, best_index);
+    return key_min_from(s, key, i, reduce_key_lanes(keys, lanes, 2));
+}
+
+__attribute__((target("sse4.2")))
+static int ratio_ties_sse42(const Scan *s, int end, double top) {
+    __m128i now = _mm_set1_epi64x(s->now);
+    __m128d target = _mm_set1_pd(top);
+    __m128i range = _mm_setzero_si128();
+    int best = -1;
+    
+    for (int i = 0; i < end; i += 2) {
+        __m128i ready = ready_sse42(s, i, now);
+        if (_mm_testz_si128(ready, ready)) {
+            continue;
+        }
+        int equal = _mm_movemask_pd(_mm_cmpeq_pd(ratio_sse42(s, i, now, ready, &range), target));
+        for (int lane = 0; lane < 2; lane++) {
+            if ((equal >> lane & 1) && ratio_above(s, i + lane, best)) {
+                best = i + lane;
+            }
+        }
+    }
+    return best;
+}
+
+__attribute__((target("sse4.2")))
+static int ratio_max_sse42(const Scan *s) {
+    __m128i now = _mm_set1_epi64x(s->now);
+    __m128d best = _mm_set1_pd(-1.0);
+    __m128i best_index = _mm_set1_epi64x(-1);
+    __m128d tied = _mm_setzero_pd();
+    __m128i range = _mm_setzero_si128();
+    __m128i lane = _mm_set_epi64x(1, 0);
+    int i = 0;
+    
+    for (; i + 2 <= s->n; i += 2) {
+        __m128i ready = ready_sse42(s, i, now);
+        if (_mm_testz_si128(ready, ready)) {
+            continue;
+        }
+        __m128d ratio = ratio_sse42(s, i, now, ready, &range);
+        __m128d equal = _mm_and_pd(_mm_castsi128_pd(ready), _mm_cmpeq_pd(ratio, best));
+        __m128d above = _mm_cmpgt_pd(ratio, best);
+        tied = _mm_or_pd(tied, equal);
+        best = _mm_blendv_pd(best, ratio, above);
+        best_index = _mm_blendv_epi8(best_index, _mm_add_epi64(_mm_set1_epi64x(i), lane), _mm_castpd_si128(above));
+    }
+    if (!_mm_testz_si128(range, _mm_set1_epi64x(RATIO_RANGE))) {
+        return ratio_max_from(s, 0, -1);
+    }
+    
+    double ratios[2];
+    long long lanes[2];
+    double top;
+    _mm_storeu_pd(ratios, best);
+    _mm_storeu_si128((__m128i *)lanes, best_index);
+    int winner = reduce_ratio_lanes(ratios, lanes, _mm_movemask_pd(tied), 2, &top);
+    if (winner < 0 && top >= 0) {
+        winner = ratio_ties_sse42(s, i, top);
+    }
+    return ratio_max_from(s, i, winner);
+}
+
+#endif
+
+static int key_min(int isa, const Scan *s, ScanKey key) {
+#ifdef SELECT_X86
+    if (isa == SELECT_AVX2) {
+        return key_min_avx2(s, key);
+    }
+    if (isa == SELECT_SSE42) {
+        return key_min_sse42(s, key);
+    }
+#endif
+    (void)isa;
+    return key_min_from(s, key, 0, -1);
+}
+
+static int ratio_max(int isa, const Scan *s) {
+#ifdef SELECT_X86
+    if (isa == SELECT_AVX2) {
+        return ratio_max_avx2(s);
+    }
+    if (isa == SELECT_SSE42) {
+        return ratio_max_sse42(s);
+    }
+#endif
+    (void)isa;
+    return ratio_max_from(s, 0, -1);
+}
+
+int select_supports(int algorithm) {
+    return algorithm == ALGORITHM_SJF || algorithm == ALGORITHM_PRIORITY || algorithm == ALGORITHM_HRRN ||
+           algorithm == ALGORITHM_LJF;
+}
+
+int select_next_with(int algorithm, int isa, const Workload *workload, const long long *completion_time,
+                     long long now) {
+    if (!select_supports(algorithm)) {
+        return SELECT_ERR_ALGORITHM;
+    }
+    if (!select_isa_supported(isa)) {
+        return SELECT_ERR_ISA;
+    }
+    if (workload->bursts != NULL) {
+        return SELECT_ERR_BURSTS;
+    }
+    
+    Scan s = { workload->n, workload->arrival_time, completion_time, workload->burst_time, workload->priority,
+               now };
+    int best;
+    switch (algorithm) {
+        case ALGORITHM_SJF: best = key_min(isa, &s, KEY_BURST); break;
+        case ALGORITHM_PRIORITY: best = key_min(isa, &s, KEY_PRIORITY); break;
+        case ALGORITHM_LJF: best = key_min(isa, &s, KEY_LONGEST); break;
+        default: best = ratio_max(isa, &s); break;
+    }
+    return best >= 0 ? best : SELECT_NONE;
+}
+
+int select_next(int algorithm, const Workload *workload, const long long *completion_time, long long now) {
+    return select_next_with(algorithm, select_best_isa(), workload, completion_time, now);
+}
+
+int select_isa_supported(int isa) {
+    switch (isa) {
+        case SELECT_SCALAR: return 1;
+#ifdef SELECT_X86
+        case SELECT_SSE42: return __builtin_cpu_supports("sse4.2") != 0;
+        case SELECT_AVX2: return __builtin_cpu_supports("avx2") != 0;
+#endif
+        default: return 0;
+    }
+}
+
+int select_best_isa(void) {
+    if (select_isa_supported(SELECT_AVX2)) {
+        return SELECT_AVX2;
+    }
+    if (select_isa_supported(SELECT_SSE42)) {
+        return SELECT_SSE42;
+    }
+    return SELECT_SCALAR;
+}
+
+const char *select_isa_name(int isa) {
+    switch (isa) {
+        case SELECT_SCALAR: return "scalar";
+        case SELECT_SSE42: return "sse4.2";
+        case SELECT_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+const char *select_error_string(int error) {
+    switch (error) {
+        case SELECT_NONE: return "no process is ready";
+        case SELECT_ERR_ALGORITHM: return "not SJF, Priority, HRRN or LJF";
+        case SELECT_ERR_ISA: return "kernel set not supported by this CPU";
+        case SELECT_ERR_BURSTS: return "burst sequences are not supported";
+        default: return "unknown error";
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef SELECT_H
+#define SELECT_H
+
+#include "scheduling.h"
+
+// Selection scans over the workload columns: the process SJF, Priority, HRRN
+// or LJF would start at time now, found by one pass over every process. A
+// process is ready when it has arrived (arrival_time <= now) and has not
+// completed (completion_time == 0); the caller fills in completion_time as
+// processes finish, the way a RunState does. The simulations keep heaps and a
+// kinetic tournament instead, which cost O(log n) per decision; a scan costs
+// O(n) but needs no state, so it answers one-off queries on a snapshot.
+// Nothing in the library calls the scans, so select.c is built into
+// bench-scheduler only, which times them against each other with --select.
+// The workload must pass workload_check().
+//
+// Each scan streams the arrival, completion and key columns with no gathers,
+// and branches once per block of four (or two) processes, to skip a block
+// with none ready. There are AVX2 and SSE4.2 versions on x86 and
+// a scalar one everywhere, all returning the same process: the lowest burst,
+// lowest priority value or highest burst, ties to the lower index, or for
+// HRRN the highest (now - arrival + burst) / burst. HRRN compares ratios in
+// double and settles equal doubles by exact integer cross-multiplication,
+// like the tournament, so ties also go to the lower index.
+
+#define SELECT_SCALAR 0
+#define SELECT_SSE42 1
+#define SELECT_AVX2 2
+
+#define SELECT_NONE -1                  // No process is ready
+#define SELECT_ERR_ALGORITHM -2         // Not SJF, Priority, HRRN or LJF
+#define SELECT_ERR_ISA -3               // Kernel set not supported by this CPU
+#define SELECT_ERR_BURSTS -4            // Burst sequences
+
+// 1 when algorithm (a menu number) has a selection scan
+int select_supports(int algorithm);
+
+// Index of the process algorithm picks at time now, with the widest kernel
+// set the CPU supports, or a SELECT_ code (all negative)
+int select_next(int algorithm, const Workload *workload, const long long *completion_time, long long now);
+
+// select_next() with the kernel set isa
+int select_next_with(int algorithm, int isa, const Workload *workload, const long long *completion_time,
+                     long long now);
+
+// 1 if the CPU can run the kernel set isa
+int select_isa_supported(int isa);
+
+// The widest supported kernel set
+int select_best_isa(void);
+
+// "scalar", "sse4.2" or "avx2"
+const char *select_isa_name(int isa);
+
+const char *select_error_string(int error);
+
+#endif
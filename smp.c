@@ -0,0 +1,602 @@
+#include "smp.h"
+#include "heap.h"
+#include "workload.h"
+#include <limits.h>
+
+#define SMP_MIN_CAPACITY 16
+
+// Growable min-heap on (key, index), or a ring buffer for the FIFO policies
+typedef struct {
+    KeyedIndex *items;
+    int size;
+    int capacity;
+    int front;                          // Ring buffer only
+} SmpQueue;
+
+// End of a slice; stale once the CPU's version has moved on (preemption)
+typedef struct {
+    long long time;
+    int cpu;
+    unsigned version;
+} SmpEvent;
+
+typedef struct {
+    int running;                        // Process on the CPU, or -1 when idle
+    int last;                           // Last process it ran, or -1
+    long long start;                    // Useful work starts, after any migration or switch cost
+    long long end;                      // The current slice ends
+    unsigned version;
+    int pending;                        // Listed for the next dispatch pass
+    int last_ended;                     // The last process ran to the end of its burst
+    long long switch_end;               // The switch overhead of the current slice is paid
+    long long idle_since;               // The CPU last went idle
+} SmpCpu;
+
+typedef struct {
+    int algorithm;
+    int balance;
+    long long migration_cost;
+    long long time_quantum;
+    SwitchCost cost;
+    const Workload *workload;
+    RunState *state;
+    SmpStats *stats;
+    int fifo;                           // Queues are ring buffers (FCFS and Round Robin)
+    int failed;                         // A queue could not grow
+    
+    int cpus;
+    SmpCpu *cpu;
+    SmpQueue *queue;                    // One per CPU, then the global queue
+    long long *queued;                  // Queue length per CPU
+    long long *load;                    // Queue length plus the running process
+    IndexedHeap least;                  // Every CPU, least loaded first
+    IndexedHeap busiest;                // Every CPU, longest queue first
+    long long *ends;                    // SRJF with a global queue: end of each CPU's slice, 0 when idle
+    IndexedHeap running;                // Every CPU, latest end first
+    long long total_queued;
+    int *pending;                       // CPUs whose queue or slice changed this instant
+    int pending_count;
+    
+    SmpEvent *events;
+    int event_count;
+    int event_capacity;
+    
+    int *last_cpu;                      // Per process, -1 until it first runs
+    long long sequence;                 // Round Robin enqueue order
+} Smp;
+
+// ---------------------------------------------------------------------------
+// Queues
+// ---------------------------------------------------------------------------
+
+static int event_less(SmpEvent a, SmpEvent b) {
+    return a.time < b.time || (a.time == b.time && a.cpu < b.cpu);
+}
+
+HEAP_DEFINE(event_heap, SmpEvent, event_less)
+
+static int queue_push(SmpQueue *queue, int fifo, long long key, int idx) {
+    if (queue->size == queue->capacity) {
+        int capacity = queue->capacity > 0 ? queue->capacity * 2 : SMP_MIN_CAPACITY;
+        KeyedIndex *grown = (KeyedIndex *)realloc(queue->items, capacity * sizeof(KeyedIndex));
+        if (grown == NULL) {
+            return -1;
+        }
+        // Unwrap the ring into the new space
+        for (int k = 0; k < queue->front + queue->size - queue->capacity; k++) {
+            grown[queue->capacity + k] = grown[k];
+        }
+        queue->items = grown;
+        queue->capacity = capacity;
+    }
+    
+    KeyedIndex entry = { key, idx };
+    if (fifo) {
+        int pos = queue->front + queue->size++;
+        queue->items[pos < queue->capacity ? pos : pos - queue->capacity] = entry;
+    } else {
+        keyed_heap_push(queue->items, &queue->size, entry);
+    }
+    return 0;
+}
+
+static int queue_pop(SmpQueue *queue, int fifo) {
+    if (fifo) {
+        int top = queue->items[queue->front].idx;
+        queue->front = queue->front + 1 < queue->capacity ? queue->front + 1 : 0;
+        queue->size--;
+        return top;
+    }
+    return keyed_heap_pop(queue->items, &queue->size).idx;
+}
+
+static int event_push(Smp *s, long long time, int cpu) {
+    if (s->event_count == s->event_capacity) {
+        int capacity = s->event_capacity * 2;
+        SmpEvent *grown = (SmpEvent *)realloc(s->events, capacity * sizeof(SmpEvent));
+        if (grown == NULL) {
+            return -1;
+        }
+        s->events = grown;
+        s->event_capacity = capacity;
+    }
+    
+    SmpEvent event = { time, cpu, s->cpu[cpu].version };
+    event_heap_push(s->events, &s->event_count, event);
+    return 0;
+}
+
+static SmpEvent event_pop(Smp *s) {
+    return event_heap_pop(s->events, &s->event_count);
+}
+
+// Every CPU in one indexed heap on key[cpu]; all keys start at zero
+static int cpu_heap_init(IndexedHeap *h, int cpus, const long long *key, int descending) {
+    if (indexed_init(h, cpus, key, NULL) != 0) {
+        return -1;
+    }
+    h->descending = descending;
+    for (int cpu = 0; cpu < cpus; cpu++) {
+        indexed_push(h, cpu);
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Simulation
+// ---------------------------------------------------------------------------
+
+static long long queue_key(Smp *s, int idx) {
+    switch (s->algorithm) {
+        case ALGORITHM_FCFS: return s->workload->arrival_time[idx];
+        case ALGORITHM_SJF: return s->workload->burst_time[idx];
+        case ALGORITHM_SRJF: return s->state->remaining_time[idx];
+        case ALGORITHM_ROUND_ROBIN: return s->sequence++;
+        case ALGORITHM_PRIORITY: return s->workload->priority[idx];
+        default: return -s->workload->burst_time[idx];      // LJF
+    }
+}
+
+static void mark_pending(Smp *s, int cpu) {
+    if (!s->cpu[cpu].pending) {
+        s->cpu[cpu].pending = 1;
+        s->pending[s->pending_count++] = cpu;
+    }
+}
+
+static void set_load(Smp *s, int cpu) {
+    long long load = s->queued[cpu] + (s->cpu[cpu].running != -1);
+    if (load != s->load[cpu]) {
+        s->load[cpu] = load;
+        indexed_update(&s->least, cpu);
+    }
+    if (s->ends != NULL) {
+        s->ends[cpu] = s->cpu[cpu].running != -1 ? s->cpu[cpu].end : 0;
+        indexed_update(&s->running, cpu);
+    }
+}
+
+static void set_queued(Smp *s, int cpu, int change) {
+    s->queued[cpu] += change;
+    s->total_queued += change;
+    if (s->balance == SMP_STEAL) {
+        indexed_update(&s->busiest, cpu);
+    }
+    set_load(s, cpu);
+}
+
+// Queues idx on a CPU, or on the global queue when cpu == s->cpus
+static void enqueue(Smp *s, int cpu, int idx) {
+    if (queue_push(&s->queue[cpu], s->fifo, queue_key(s, idx), idx) != 0) {
+        s->failed = 1;
+        return;
+    }
+    if (cpu < s->cpus) {
+        set_queued(s, cpu, 1);
+        mark_pending(s, cpu);
+    }
+}
+
+static int dequeue(Smp *s, int cpu) {
+    int idx = queue_pop(&s->queue[cpu], s->fifo);
+    if (cpu < s->cpus) {
+        set_queued(s, cpu, -1);
+    }
+    return idx;
+}
+
+// Time idx still needs if it keeps the CPU it is running on
+static long long remaining_now(const Smp *s, int cpu, long long now) {
+    const SmpCpu *c = &s->cpu[cpu];
+    return c->end - (now > c->start ? now : c->start);
+}
+
+// Starts a slice of idx on an idle CPU
+static void dispatch(Smp *s, int cpu, int idx, long long now) {
+    SmpCpu *c = &s->cpu[cpu];
+    SmpCpuStats *stats = &s->stats->cpu[cpu];
+    RunCounters *counters = &s->state->counters;
+    int migrating = s->last_cpu[idx] != -1 && s->last_cpu[idx] != cpu;
+    
+    if (c->last != -1 && c->idle_since < now) {
+        counters->idle_transitions++;
+    }
+    int cold = !migrating && s->state->remaining_time[idx] < s->workload->burst_time[idx];
+    long long overhead = run_counters_dispatch(counters, &s->cost, c->last, c->last_ended, idx, cold);
+    stats->switch_time += overhead;
+    c->switch_end = now + overhead;
+    long long start = c->switch_end;
+    
+    if (migrating) {
+        stats->migrations++;
+        stats->migration_time += s->migration_cost;
+        counters->overhead_time += s->migration_cost;
+        s->stats->migrations++;
+        start += s->migration_cost;
+    }
+    s->last_cpu[idx] = cpu;
+    
+    stats->dispatches++;
+    if (c->last != -1 && c->last != idx) {
+        stats->context_switches++;
+    }
+    c->last = idx;
+    
+    long long run_time = s->state->remaining_time[idx];
+    if (s->algorithm == ALGORITHM_ROUND_ROBIN && run_time > s->time_quantum) {
+        run_time = s->time_quantum;
+    }
+    c->running = idx;
+    c->start = start;
+    c->end = start + run_time;
+    set_load(s, cpu);
+    if (event_push(s, c->end, cpu) != 0) {
+        s->failed = 1;
+    }
+}
+
+// Takes the running process off a CPU at now, crediting the work it did
+static int stop(Smp *s, int cpu, long long now) {
+    SmpCpu *c = &s->cpu[cpu];
+    int idx = c->running;
+    long long ran = now > c->start ? now - c->start : 0;
+    
+    // Switch and migration overhead not yet paid when the process loses the
+    // CPU is never spent
+    if (c->start > now) {
+        long long unpaid_switch = c->switch_end > now ? c->switch_end - now : 0;
+        s->stats->cpu[cpu].switch_time -= unpaid_switch;
+        s->stats->cpu[cpu].migration_time -= c->start - now - unpaid_switch;
+        s->state->counters.overhead_time -= c->start - now;
+    }
+    // A process only counts as having run once it does some work
+    if (ran > 0 && s->state->response_time[idx] == -1) {
+        s->state->response_time[idx] = c->start - s->workload->arrival_time[idx];
+    }
+    s->state->remaining_time[idx] -= ran;
+    s->stats->cpu[cpu].busy_time += ran;
+    if (s->state->timeline != NULL) {
+        timeline_record(s->state->timeline, s->workload->pid[idx], cpu, c->start, c->start + ran);
+    }
+    c->last_ended = s->state->remaining_time[idx] == 0;
+    c->idle_since = now;
+    c->running = -1;
+    c->version++;
+    set_load(s, cpu);
+    mark_pending(s, cpu);
+    return idx;
+}
+
+// Where a new or preempted process is queued
+static int place(Smp *s, int home) {
+    switch (s->balance) {
+        case SMP_GLOBAL: return s->cpus;
+        case SMP_PUSH: return s->least.heap[0];
+        default: return home;
+    }
+}
+
+// SRJF: the running process yields if a queued one needs less time
+static void preempt_if_shorter(Smp *s, int cpu, long long now) {
+    SmpCpu *c = &s->cpu[cpu];
+    SmpQueue *queue = &s->queue[cpu];
+    if (c->running == -1 || queue->size == 0) {
+        return;
+    }
+    KeyedIndex running = { remaining_now(s, cpu, now), c->running };
+    if (keyed_less(queue->items[0], running)) {
+        enqueue(s, cpu, stop(s, cpu, now));
+    }
+}
+
+// Finds the running CPU whose (remaining time, process) is largest in the
+// subtree of the running heap at at. A CPU's slice ends at least its
+// remaining time after now, and later while it still pays overhead, so a
+// subtree whose top ends less than the best remaining time after now is
+// skipped, and so are idle CPUs, which sort last.
+static void find_worst(const Smp *s, int at, long long now, int *worst, KeyedIndex *worst_entry) {
+    if (at >= s->running.size) {
+        return;
+    }
+    int cpu = s->running.heap[at];
+    if (s->ends[cpu] == 0 || (*worst != -1 && s->ends[cpu] - now < worst_entry->key)) {
+        return;
+    }
+    KeyedIndex entry = { remaining_now(s, cpu, now), s->cpu[cpu].running };
+    if (*worst == -1 || keyed_less(*worst_entry, entry)) {
+        *worst = cpu;
+        *worst_entry = entry;
+    }
+    find_worst(s, 2 * at + 1, now, worst, worst_entry);
+    find_worst(s, 2 * at + 2, now, worst, worst_entry);
+}
+
+// SRJF with a global queue: preempts the CPUs running the longest remaining
+// work for as long as the queue holds something shorter. With every running
+// CPU past its overhead, the search only visits the CPUs whose slices end
+// last, so each preemption costs O(log M).
+static void preempt_global(Smp *s, long long now) {
+    SmpQueue *queue = &s->queue[s->cpus];
+    while (queue->size > 0) {
+        int worst = -1;
+        KeyedIndex worst_entry = { 0, 0 };
+        find_worst(s, 0, now, &worst, &worst_entry);
+        if (worst == -1 || !keyed_less(queue->items[0], worst_entry)) {
+            return;
+        }
+        int idx = stop(s, worst, now);
+        dispatch(s, worst, dequeue(s, s->cpus), now);
+        enqueue(s, s->cpus, idx);
+    }
+}
+
+// Gives work to every idle CPU that can get some at now
+static void dispatch_idle(Smp *s, long long now, int arrivals) {
+    if (s->balance == SMP_GLOBAL) {
+        // The shared queue serves any idle CPU, so the pending list is unused
+        for (int k = 0; k < s->pending_count; k++) {
+            s->cpu[s->pending[k]].pending = 0;
+        }
+        s->pending_count = 0;
+        
+        SmpQueue *queue = &s->queue[s->cpus];
+        while (queue->size > 0 && s->load[s->least.heap[0]] == 0) {
+            int idx = dequeue(s, s->cpus);
+            int cpu = s->last_cpu[idx];
+            if (cpu == -1 || s->cpu[cpu].running != -1) {
+                cpu = s->least.heap[0];
+            }
+            dispatch(s, cpu, idx, now);
+        }
+        if (arrivals && s->algorithm == ALGORITHM_SRJF) {
+            preempt_global(s, now);
+        }
+        return;
+    }
+    
+    for (int k = 0; k < s->pending_count; k++) {
+        int cpu = s->pending[k];
+        s->cpu[cpu].pending = 0;
+        if (s->cpu[cpu].running != -1) continue;
+        
+        // Push migration: an overloaded CPU hands work to idle ones
+        while (s->balance == SMP_PUSH && s->queued[cpu] > 1 && s->load[s->least.heap[0]] == 0) {
+            dispatch(s, s->least.heap[0], dequeue(s, cpu), now);
+        }
+        if (s->queued[cpu] > 0) {
+            dispatch(s, cpu, dequeue(s, cpu), now);
+        }
+    }
+    s->pending_count = 0;
+    
+    // Work stealing: idle CPUs with nothing queued pull from the longest queue
+    while (s->balance == SMP_STEAL && s->total_queued > 0 && s->load[s->least.heap[0]] == 0) {
+        int thief = s->least.heap[0];
+        dispatch(s, thief, dequeue(s, s->busiest.heap[0]), now);
+    }
+}
+
+static void simulate(Smp *s) {
+    const Workload *workload = s->workload;
+    const int *order = workload->arrival_order;
+    int n = workload->n;
+    int next_arrival = 0;
+    int completed = 0;
+    
+    while (completed < n && !s->failed) {
+        while (s->event_count > 0 && s->events[0].version != s->cpu[s->events[0].cpu].version) {
+            event_pop(s);
+        }
+        long long now = LLONG_MAX;
+        if (s->event_count > 0) {
+            now = s->events[0].time;
+        }
+        if (next_arrival < n && workload->arrival_time[order[next_arrival]] < now) {
+            now = workload->arrival_time[order[next_arrival]];
+        }
+        
+        // Slices ending now come first, so a preempted Round Robin process
+        // queues ahead of the processes arriving at the same time
+        while (s->event_count > 0 && s->events[0].time == now) {
+            SmpEvent event = event_pop(s);
+            if (event.version != s->cpu[event.cpu].version) continue;
+            
+            int cpu = event.cpu;
+            int idx = stop(s, cpu, now);
+            if (s->state->remaining_time[idx] == 0) {
+                s->state->completion_time[idx] = now;
+                s->stats->cpu[cpu].completed++;
+                completed++;
+            } else {
+                int target = s->balance == SMP_GLOBAL ? s->cpus : cpu;
+                enqueue(s, target, idx);
+            }
+        }
+        
+        int arrivals = 0;
+        while (next_arrival < n && workload->arrival_time[order[next_arrival]] == now) {
+            int idx = order[next_arrival];
+            int cpu = place(s, next_arrival % s->cpus);
+            next_arrival++;
+            arrivals++;
+            enqueue(s, cpu, idx);
+            if (s->algorithm == ALGORITHM_SRJF && cpu < s->cpus) {
+                preempt_if_shorter(s, cpu, now);
+            }
+        }
+        
+        dispatch_idle(s, now, arrivals);
+    }
+}
+
+static void free_smp(Smp *s) {
+    if (s->queue != NULL) {
+        for (int cpu = 0; cpu <= s->cpus; cpu++) {
+            free(s->queue[cpu].items);
+        }
+    }
+    free(s->queue);
+    free(s->cpu);
+    free(s->queued);
+    free(s->load);
+    free(s->pending);
+    free(s->events);
+    free(s->last_cpu);
+    indexed_free(&s->least);
+    indexed_free(&s->busiest);
+    indexed_free(&s->running);
+    free(s->ends);
+}
+
+int smp_run(int algorithm, Workload *workload, RunState *state, const SmpConfig *config,
+            SmpStats *stats) {
+    int cpus = config->cpus;
+    int n = workload->n;
+    memset(stats, 0, sizeof(SmpStats));
+    
+    if (algorithm < ALGORITHM_FCFS || algorithm > ALGORITHM_LJF || algorithm == ALGORITHM_HRRN) {
+        return SMP_ERR_UNSUPPORTED;
+    }
+    if (cpus < 1 || config->balance < SMP_GLOBAL || config->balance > SMP_STEAL ||
+        config->migration_cost < 0 || config->cost.context_switch < 0 || config->cost.warmup < 0 ||
+        (algorithm == ALGORITHM_ROUND_ROBIN && config->time_quantum <= 0) ||
+        (state->timeline != NULL && state->timeline->cpus < cpus)) {
+        return SMP_ERR_CONFIG;
+    }
+    if (workload->bursts != NULL) {
+        return SMP_ERR_BURSTS;
+    }
+    if (workload_check(workload) != WORKLOAD_OK) {
+        return SMP_ERR_WORKLOAD;
+    }
+    
+    stats->cpus = cpus;
+    stats->cpu = (SmpCpuStats *)calloc(cpus, sizeof(SmpCpuStats));
+    if (stats->cpu == NULL || workload_index(workload) != WORKLOAD_OK) {
+        return SMP_ERR_MEMORY;
+    }
+    run_state_reset(state, workload);
+    
+    Smp s;
+    memset(&s, 0, sizeof(Smp));
+    s.algorithm = algorithm;
+    s.balance = config->balance;
+    s.migration_cost = config->migration_cost;
+    s.time_quantum = config->time_quantum;
+    s.cost = config->cost;
+    s.fifo = algorithm == ALGORITHM_FCFS || algorithm == ALGORITHM_ROUND_ROBIN;
+    s.workload = workload;
+    s.state = state;
+    s.stats = stats;
+    s.cpus = cpus;
+    s.cpu = (SmpCpu *)malloc(cpus * sizeof(SmpCpu));
+    s.queue = (SmpQueue *)calloc(cpus + 1, sizeof(SmpQueue));
+    s.queued = (long long *)calloc(cpus, sizeof(long long));
+    s.load = (long long *)calloc(cpus, sizeof(long long));
+    s.pending = (int *)malloc(cpus * sizeof(int));
+    s.event_capacity = cpus * 2;
+    s.events = (SmpEvent *)malloc(s.event_capacity * sizeof(SmpEvent));
+    s.last_cpu = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    int heaps = cpu_heap_init(&s.least, cpus, s.load, 0);
+    heaps |= cpu_heap_init(&s.busiest, cpus, s.queued, 1);
+    if (s.balance == SMP_GLOBAL && algorithm == ALGORITHM_SRJF) {
+        s.ends = (long long *)calloc(cpus, sizeof(long long));
+        heaps |= s.ends == NULL || cpu_heap_init(&s.running, cpus, s.ends, 1) != 0;
+    }
+    
+    if (heaps != 0 || s.cpu == NULL || s.queue == NULL || s.queued == NULL || s.load == NULL ||
+        s.pending == NULL || s.events == NULL || s.last_cpu == NULL) {
+        free_smp(&s);
+        return SMP_ERR_MEMORY;
+    }
+    for (int cpu = 0; cpu < cpus; cpu++) {
+        SmpCpu blank = { -1, -1, 0, 0, 0, 0, 0, 0, 0 };
+        s.cpu[cpu] = blank;
+    }
+    for (int i = 0; i < n; i++) {
+        s.last_cpu[i] = -1;
+    }
+    
+    simulate(&s);
+    int failed = s.failed;
+    stats->total_time = run_total_time(state);
+    for (int cpu = 0; cpu < cpus; cpu++) {
+        // CPUs that went idle before the last process completed
+        if (s.cpu[cpu].last != -1 && s.cpu[cpu].idle_since < stats->total_time) {
+            state->counters.idle_transitions++;
+        }
+    }
+    free_smp(&s);
+    if (failed) {
+        return SMP_ERR_MEMORY;
+    }
+    
+    long long busiest = 0;
+    long long busy_total = 0;
+    for (int cpu = 0; cpu < cpus; cpu++) {
+        busy_total += stats->cpu[cpu].busy_time;
+        if (stats->cpu[cpu].busy_time > busiest) {
+            busiest = stats->cpu[cpu].busy_time;
+        }
+    }
+    if (busy_total > 0) {
+        double mean = (double)busy_total / cpus;
+        stats->imbalance = (busiest - mean) / mean * 100.0;
+    }
+    return SMP_OK;
+}
+
+void smp_stats_free(SmpStats *stats) {
+    free(stats->cpu);
+    stats->cpu = NULL;
+}
+
+int smp_balance_parse(const char *name) {
+    for (int balance = SMP_GLOBAL; balance <= SMP_STEAL; balance++) {
+        if (strcmp(name, smp_balance_name(balance)) == 0) {
+            return balance;
+        }
+    }
+    return -1;
+}
+
+const char *smp_balance_name(int balance) {
+    switch (balance) {
+        case SMP_GLOBAL: return "global";
+        case SMP_PUSH: return "push";
+        case SMP_STEAL: return "steal";
+        default: return NULL;
+    }
+}
+
+const char *smp_error_string(int error) {
+    switch (error) {
+        case SMP_OK: return "no error";
+        case SMP_ERR_MEMORY: return "out of memory";
+        case SMP_ERR_UNSUPPORTED: return "algorithm not available on multiple CPUs";
+        case SMP_ERR_CONFIG: return "invalid CPU count, balancing mode, migration or switch cost, quantum, or timeline CPUs";
+        case SMP_ERR_BURSTS: return "burst sequences are not available on multiple CPUs";
+        case SMP_ERR_WORKLOAD: return "negative arrival, deadline or period, or non-positive burst";
+        default: return "unknown error";
+    }
+}
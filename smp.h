@@ -0,0 +1,78 @@
+#ifndef SMP_H
+#define SMP_H
+
+#include "scheduling.h"
+
+// Multi-CPU simulation. Every CPU runs the chosen policy over its own ready
+// queue (or one shared queue, with SMP_GLOBAL), and processes move between
+// CPUs according to the balancing mode. A process that resumes on a CPU
+// other than the one it last ran on pays the migration cost before it does
+// any work, on top of the switch cost; warmup only applies to a process
+// resuming where it ran before, as migration already refills its cache.
+// Both count as overhead in the run state's counters, less whatever is
+// still unpaid when the process is preempted. Switches are counted per
+// CPU, into the run state's counters. A timeline
+// in the run state records each CPU's slices and needs a track per CPU.
+// With one CPU the schedule is the single-CPU one, except that processes
+// queue at the instant they arrive: all processes arriving together are
+// admitted before the CPU picks among them, under Round Robin a process
+// arriving during a slice queues ahead of the process preempted at its end,
+// and under SRJF an arrival can take the CPU back while the switch overhead
+// is still being paid, where the single-CPU core decides again only once it
+// is paid. Either way, a process's response time is taken when it first
+// does work, not when it is dispatched.
+// HRRN and LRJF have no multi-CPU version.
+
+#define SMP_OK 0
+#define SMP_ERR_MEMORY -1
+#define SMP_ERR_UNSUPPORTED -2
+#define SMP_ERR_CONFIG -3
+#define SMP_ERR_BURSTS -4
+#define SMP_ERR_WORKLOAD -5              // Fails workload_check()
+
+// Load balancing modes
+#define SMP_GLOBAL 0                    // One queue shared by every CPU
+#define SMP_PUSH 1                      // Work goes to, and is pushed to, the least loaded CPU
+#define SMP_STEAL 2                     // Work stays home; idle CPUs steal from the longest queue
+
+typedef struct {
+    int cpus;
+    int balance;
+    long long migration_cost;           // Time lost by a process that changes CPU
+    long long time_quantum;             // Round Robin only
+    SwitchCost cost;
+} SmpConfig;
+
+typedef struct {
+    long long busy_time;                // Time spent running processes
+    long long migration_time;           // Time lost to migration cost
+    long long switch_time;              // Time lost to context switches and warmup
+    long long dispatches;               // Slices started
+    long long context_switches;         // Dispatches of a different process than the last
+    long long migrations;               // Processes that moved to this CPU
+    int completed;
+} SmpCpuStats;
+
+typedef struct {
+    int cpus;
+    SmpCpuStats *cpu;                   // One entry per CPU
+    long long migrations;
+    long long total_time;
+    double imbalance;                   // Busiest CPU's busy time over the mean, in percent above it
+} SmpStats;
+
+// Runs the algorithm (see algorithm_name()) on config->cpus CPUs. Builds the
+// arrival index if needed; results go to state and stats, which must be
+// released with smp_stats_free() even when the run fails. Returns an SMP_
+// code: SMP_ERR_WORKLOAD for a negative arrival or a burst below 1.
+int smp_run(int algorithm, Workload *workload, RunState *state, const SmpConfig *config,
+            SmpStats *stats);
+void smp_stats_free(SmpStats *stats);
+
+// Balancing mode by name ("global", "push" or "steal"), or -1
+int smp_balance_parse(const char *name);
+const char *smp_balance_name(int balance);
+
+const char *smp_error_string(int error);
+
+#endif
@@ -0,0 +1,168 @@
+#include "timeline.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TIMELINE_INITIAL 4096
+#define WRITER_BUFFER (1 << 20)
+#define WRITER_RECORD 256       // Longest record written in one piece
+
+int timeline_init(Timeline *timeline, int cpus) {
+    memset(timeline, 0, sizeof(Timeline));
+    timeline->cpus = cpus > 0 ? cpus : 1;
+    timeline->last = (size_t *)calloc(timeline->cpus, sizeof(size_t));
+    timeline->segments = (TimelineSegment *)malloc(TIMELINE_INITIAL * sizeof(TimelineSegment));
+    if (timeline->last == NULL || timeline->segments == NULL) {
+        return -1;
+    }
+    timeline->capacity = TIMELINE_INITIAL;
+    return 0;
+}
+
+void timeline_free(Timeline *timeline) {
+    free(timeline->segments);
+    free(timeline->last);
+    memset(timeline, 0, sizeof(Timeline));
+}
+
+void timeline_clear(Timeline *timeline) {
+    timeline->count = 0;
+    timeline->failed = 0;
+    memset(timeline->last, 0, timeline->cpus * sizeof(size_t));
+}
+
+int timeline_grow(Timeline *timeline) {
+    size_t capacity = timeline->capacity > 0 ? timeline->capacity * 2 : TIMELINE_INITIAL;
+    TimelineSegment *segments = (TimelineSegment *)realloc(timeline->segments, capacity * sizeof(TimelineSegment));
+    if (segments == NULL) {
+        return -1;
+    }
+    timeline->segments = segments;
+    timeline->capacity = capacity;
+    return 0;
+}
+
+// Output buffer that goes to the sink only when full
+typedef struct {
+    TimelineSink sink;
+    void *context;
+    char *buffer;
+    size_t used;
+    int failed;
+} Writer;
+
+static void writer_flush(Writer *writer) {
+    if (writer->used > 0 && !writer->failed && writer->sink(writer->context, writer->buffer, writer->used) != 0) {
+        writer->failed = 1;
+    }
+    writer->used = 0;
+}
+
+// Makes room for one record of at most WRITER_RECORD bytes
+static char *writer_reserve(Writer *writer) {
+    if (writer->used > WRITER_BUFFER - WRITER_RECORD) {
+        writer_flush(writer);
+    }
+    return writer->buffer + writer->used;
+}
+
+static char *put_text(char *at, const char *text) {
+    size_t length = strlen(text);
+    memcpy(at, text, length);
+    return at + length;
+}
+
+static char *put_number(char *at, long long value) {
+    char digits[20];
+    int count = 0;
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    if (value < 0) {
+        *at++ = '-';
+    }
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0) {
+        *at++ = digits[--count];
+    }
+    return at;
+}
+
+static int writer_open(Writer *writer, TimelineSink sink, void *context) {
+    writer->sink = sink;
+    writer->context = context;
+    writer->used = 0;
+    writer->failed = 0;
+    writer->buffer = (char *)malloc(WRITER_BUFFER);
+    return writer->buffer == NULL ? -1 : 0;
+}
+
+static int writer_close(Writer *writer) {
+    writer_flush(writer);
+    free(writer->buffer);
+    return writer->failed ? -1 : 0;
+}
+
+int timeline_write_chrome(const Timeline *timeline, TimelineSink sink, void *context) {
+    Writer writer;
+    if (writer_open(&writer, sink, context) != 0) {
+        return -1;
+    }
+    
+    char *at = writer_reserve(&writer);
+    at = put_text(at, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CPU scheduler\"}}");
+    writer.used = at - writer.buffer;
+    for (int cpu = 0; cpu < timeline->cpus; cpu++) {
+        at = writer_reserve(&writer);
+        at = put_text(at, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":");
+        at = put_number(at, cpu);
+        at = put_text(at, ",\"args\":{\"name\":\"CPU ");
+        at = put_number(at, cpu);
+        at = put_text(at, "\"}}");
+        writer.used = at - writer.buffer;
+    }
+    for (size_t k = 0; k < timeline->count; k++) {
+        const TimelineSegment *segment = &timeline->segments[k];
+        at = writer_reserve(&writer);
+        at = put_text(at, ",\n{\"name\":\"P");
+        at = put_number(at, segment->pid);
+        at = put_text(at, "\",\"ph\":\"X\",\"pid\":0,\"tid\":");
+        at = put_number(at, segment->cpu);
+        at = put_text(at, ",\"ts\":");
+        at = put_number(at, segment->start);
+        at = put_text(at, ",\"dur\":");
+        at = put_number(at, segment->end - segment->start);
+        *at++ = '}';
+        writer.used = at - writer.buffer;
+    }
+    at = writer_reserve(&writer);
+    at = put_text(at, "\n]}\n");
+    writer.used = at - writer.buffer;
+    return writer_close(&writer);
+}
+
+int timeline_write_csv(const Timeline *timeline, TimelineSink sink, void *context) {
+    Writer writer;
+    if (writer_open(&writer, sink, context) != 0) {
+        return -1;
+    }
+    
+    char *at = writer_reserve(&writer);
+    at = put_text(at, "pid,cpu,start,end\n");
+    writer.used = at - writer.buffer;
+    for (size_t k = 0; k < timeline->count; k++) {
+        const TimelineSegment *segment = &timeline->segments[k];
+        at = writer_reserve(&writer);
+        at = put_number(at, segment->pid);
+        *at++ = ',';
+        at = put_number(at, segment->cpu);
+        *at++ = ',';
+        at = put_number(at, segment->start);
+        *at++ = ',';
+        at = put_number(at, segment->end);
+        *at++ = '\n';
+        writer.used = at - writer.buffer;
+    }
+    return writer_close(&writer);
+}
@@ -0,0 +1,78 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <stddef.h>
+
+// Gantt timeline of a run as run-length segments: process pid ran on cpu
+// over [start, end). A segment that continues the last one on its CPU, same
+// process with no gap, extends it instead, so a process that keeps the CPU
+// across slices costs one segment. Segments are in order of start per CPU.
+// The buffer doubles when full; if it cannot, the timeline is marked failed
+// and keeps what it has. An algorithm records only when its RunState has a
+// timeline, so a run without one pays a single pointer test per slice.
+typedef struct {
+    int pid;
+    int cpu;
+    long long start;
+    long long end;
+} TimelineSegment;
+
+typedef struct {
+    TimelineSegment *segments;
+    size_t count;
+    size_t capacity;
+    int cpus;
+    size_t *last;               // Per CPU: 1 + the index of its latest segment, 0 for none
+    int failed;                 // A segment was dropped for lack of memory
+} Timeline;
+
+// Returns 0, or -1 when out of memory; call timeline_free() either way
+int timeline_init(Timeline *timeline, int cpus);
+void timeline_free(Timeline *timeline);
+
+// Forgets every segment, keeping the memory for the next run
+void timeline_clear(Timeline *timeline);
+
+int timeline_grow(Timeline *timeline);
+
+static inline void timeline_record(Timeline *timeline, int pid, int cpu, long long start, long long end) {
+    if (end <= start) {
+        return;
+    }
+    size_t last = timeline->last[cpu];
+    if (last != 0) {
+        TimelineSegment *segment = &timeline->segments[last - 1];
+        if (segment->pid == pid && segment->end == start) {
+            segment->end = end;
+            return;
+        }
+    }
+    if (timeline->count == timeline->capacity && timeline_grow(timeline) != 0) {
+        timeline->failed = 1;
+        return;
+    }
+    TimelineSegment *segment = &timeline->segments[timeline->count++];
+    segment->pid = pid;
+    segment->cpu = cpu;
+    segment->start = start;
+    segment->end = end;
+    timeline->last[cpu] = timeline->count;
+}
+
+// Takes the next size bytes of a writer's output. Returns 0, or -1 to stop
+// the writer with an error.
+typedef int (*TimelineSink)(void *context, const char *data, size_t size);
+
+// Writers return 0, or -1 when out of memory or when the sink fails. Output
+// goes through one large buffer, with numbers formatted by hand, so each
+// segment costs a few stores and the sink is only called when the buffer
+// fills.
+
+// Chrome trace-event JSON, for chrome://tracing or Perfetto: one complete
+// ("X") event per segment on a thread per CPU, one time unit per microsecond
+int timeline_write_chrome(const Timeline *timeline, TimelineSink sink, void *context);
+
+// CSV with a header line: pid,cpu,start,end
+int timeline_write_csv(const Timeline *timeline, TimelineSink sink, void *context);
+
+#endif
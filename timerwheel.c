@@ -0,0 +1,106 @@
+#include "timerwheel.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Level of a timer expiring at expiry on a wheel whose clock reads now: the
+// highest 6-bit digit in which the two differ
+static int level_of(long long now, long long expiry) {
+    unsigned long long diff = (unsigned long long)(now ^ expiry);
+    if (diff == 0) {
+        return 0;
+    }
+    return (63 - __builtin_clzll(diff)) / TIMER_WHEEL_BITS;
+}
+
+static void insert(TimerWheel *wheel, int id) {
+    long long expiry = wheel->expiry[id];
+    int level = level_of(wheel->now, expiry);
+    int s = (int)((unsigned long long)expiry >> (level * TIMER_WHEEL_BITS)) & (TIMER_WHEEL_SLOTS - 1);
+    TimerSlot *slot = &wheel->slot[level][s];
+    
+    wheel->next[id] = -1;
+    if (slot->head == -1) {
+        slot->head = id;
+        slot->earliest = expiry;
+        wheel->occupied[level] |= 1ULL << s;
+        wheel->levels |= 1U << level;
+    } else {
+        wheel->next[slot->tail] = id;
+        if (expiry < slot->earliest) {
+            slot->earliest = expiry;
+        }
+    }
+    slot->tail = id;
+}
+
+static void clear_slot(TimerWheel *wheel, int level, int s) {
+    wheel->slot[level][s].head = -1;
+    wheel->occupied[level] &= ~(1ULL << s);
+    if (wheel->occupied[level] == 0) {
+        wheel->levels &= ~(1U << level);
+    }
+}
+
+int timer_wheel_init(TimerWheel *wheel, int capacity) {
+    memset(wheel, 0, sizeof(TimerWheel));
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++) {
+            wheel->slot[level][s].head = -1;
+        }
+    }
+    wheel->next = (int *)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    wheel->expiry = (long long *)malloc((capacity > 0 ? capacity : 1) * sizeof(long long));
+    return wheel->next == NULL || wheel->expiry == NULL ? -1 : 0;
+}
+
+void timer_wheel_free(TimerWheel *wheel) {
+    free(wheel->next);
+    free(wheel->expiry);
+    wheel->next = NULL;
+    wheel->expiry = NULL;
+}
+
+void timer_wheel_arm(TimerWheel *wheel, int id, long long expiry) {
+    wheel->expiry[id] = expiry;
+    wheel->size++;
+    insert(wheel, id);
+}
+
+// Every timer at a lower level expires before any at a higher one, and
+// within a level the lowest occupied slot comes first. A slot above level 0
+// spans many times, so it is first spread over the levels below, with the
+// clock moved to the slot's start; no timer expires before that.
+int timer_wheel_expire(TimerWheel *wheel, long long limit) {
+    while (wheel->levels != 0) {
+        int level = __builtin_ctz(wheel->levels);
+        int s = __builtin_ctzll(wheel->occupied[level]);
+        TimerSlot *slot = &wheel->slot[level][s];
+        if (slot->earliest > limit) {
+            return -1;
+        }
+    
+        int id = slot->head;
+        if (level == 0) {
+            // Every timer in a level 0 slot expires at the same time
+            slot->head = wheel->next[id];
+            if (slot->head == -1) {
+                clear_slot(wheel, 0, s);
+            }
+            wheel->now = wheel->expiry[id];
+            wheel->size--;
+            return id;
+        }
+    
+        int shift = level * TIMER_WHEEL_BITS;
+        unsigned long long start = (unsigned long long)wheel->now;
+        start = shift + TIMER_WHEEL_BITS < 64 ? start >> (shift + TIMER_WHEEL_BITS) << (shift + TIMER_WHEEL_BITS) : 0;
+        wheel->now = (long long)(start | (unsigned long long)s << shift);
+        clear_slot(wheel, level, s);
+        while (id != -1) {
+            int next = wheel->next[id];
+            insert(wheel, id);
+            id = next;
+        }
+    }
+    return -1;
+}
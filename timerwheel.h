@@ -0,0 +1,55 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <limits.h>
+
+// Hierarchical timing wheel for timers numbered 0..capacity-1, each armed at
+// most once at a time. Level k has 64 slots of 64^k time units; a timer sits
+// at the level of the highest 6-bit digit in which its expiry differs from
+// the wheel's clock, in the slot given by that digit. Arming is O(1), the
+// earliest expiry is read in O(1) from per-level occupancy bitmaps, and a
+// timer moves down at most once per level on its way to expiring, so
+// millions of pending timers cost no more per operation than a few.
+// Timers cannot be cancelled.
+
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 11               // 66 bits cover every non-negative long long
+
+typedef struct {
+    int head;                               // First timer in arming order, -1 when empty
+    int tail;
+    long long earliest;                     // Earliest expiry in the slot
+} TimerSlot;
+
+typedef struct {
+    TimerSlot slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    unsigned long long occupied[TIMER_WHEEL_LEVELS];    // Bit s set when slot s holds a timer
+    unsigned levels;                        // Bit k set when level k holds a timer
+    int *next;                              // Per timer: the next one in its slot
+    long long *expiry;                      // Per timer
+    long long now;                          // No armed timer expires before now
+    int size;                               // Timers armed
+} TimerWheel;
+
+int timer_wheel_init(TimerWheel *wheel, int capacity);
+void timer_wheel_free(TimerWheel *wheel);
+
+// Arms timer id, which must not be armed, to expire at expiry >= wheel->now
+void timer_wheel_arm(TimerWheel *wheel, int id, long long expiry);
+
+// Earliest expiry of an armed timer, LLONG_MAX when none is armed
+static inline long long timer_wheel_next(const TimerWheel *wheel) {
+    if (wheel->levels == 0) {
+        return LLONG_MAX;
+    }
+    int level = __builtin_ctz(wheel->levels);
+    return wheel->slot[level][__builtin_ctzll(wheel->occupied[level])].earliest;
+}
+
+// Disarms and returns a timer with the earliest expiry if that is at most
+// limit, else returns -1. The wheel's clock moves up to that expiry. Timers
+// due at the same time come out in no particular order.
+int timer_wheel_expire(TimerWheel *wheel, long long limit);
+
+#endif
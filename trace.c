@@ -0,0 +1,318 @@
+#include "trace.h"
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#define TRACE_CHUNK_SIZE (1 << 20)
+#define TRACE_FIELDS 6
+#define TRACE_REQUIRED_FIELDS 4
+
+typedef struct {
+    TraceSink sink;
+    void *context;
+    FILE *errors;
+    TraceStats *stats;
+    int seen_record;        // A header is only accepted before the first record
+    int stopped;            // The sink asked to stop
+    long long *bursts;      // Burst sequence of the current line
+    int burst_count;
+    int burst_capacity;
+} TraceParser;
+
+const char TRACE_STOP[] = "stop";
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static void reject_line(TraceParser *parser, long long line, const char *reason) {
+    parser->stats->rejected++;
+    if (parser->errors != NULL) {
+        fprintf(parser->errors, "line %lld: %s\n", line, reason);
+    }
+}
+
+// Parses one field starting at *cursor. Returns NULL on success or the reason
+// the field is malformed.
+static const char *parse_integer(const char **cursor, const char *end, long long *value) {
+    const char *p = *cursor;
+    int negative = 0;
+    unsigned long long magnitude = 0;
+    
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return "expected an integer";
+    }
+    while (p < end && *p >= '0' && *p <= '9') {
+        magnitude = magnitude * 10 + (unsigned long long)(*p - '0');
+        if (magnitude > (unsigned long long)LLONG_MAX) {
+            return "integer out of range";
+        }
+        p++;
+    }
+    if (p < end && !is_blank(*p) && *p != ',' && *p != '/') {
+        return "unexpected character";
+    }
+    
+    *value = negative ? -(long long)magnitude : (long long)magnitude;
+    *cursor = p;
+    return NULL;
+}
+
+static const char *add_burst(TraceParser *parser, long long burst) {
+    if (parser->burst_count == parser->burst_capacity) {
+        int capacity = parser->burst_capacity > 0 ? parser->burst_capacity * 2 : 16;
+        long long *bursts = (long long *)realloc(parser->bursts, (size_t)capacity * sizeof(long long));
+        if (bursts == NULL) {
+            return "out of memory";
+        }
+        parser->bursts = bursts;
+        parser->burst_capacity = capacity;
+    }
+    parser->bursts[parser->burst_count++] = burst;
+    return NULL;
+}
+
+// Reads the rest of a burst sequence "cpu/io/cpu/..." whose first burst is
+// in *burst, and leaves the CPU total in *burst
+static const char *parse_bursts(TraceParser *parser, const char **cursor, const char *end, long long *burst) {
+    const char *reason = add_burst(parser, *burst);
+    long long total = 0;        // CPU and I/O, so that no wakeup time can overflow
+    long long cpu = 0;
+    
+    while (reason == NULL && *cursor < end && **cursor == '/') {
+        long long value;
+        (*cursor)++;
+        reason = parse_integer(cursor, end, &value);
+        if (reason == NULL) {
+            reason = add_burst(parser, value);
+        }
+    }
+    for (int b = 0; b < parser->burst_count && reason == NULL; b++) {
+        long long value = parser->bursts[b];
+        if (value <= 0) {
+            reason = "CPU and I/O bursts must be positive";
+        } else if (value > LLONG_MAX - total) {
+            reason = "bursts add up out of range";
+        } else {
+            total += value;
+            cpu += b % 2 == 0 ? value : 0;
+        }
+    }
+    if (reason == NULL && parser->burst_count % 2 == 0) {
+        reason = "a burst sequence must end with a CPU burst";
+    }
+    *burst = cpu;
+    return reason;
+}
+
+static void parse_line(TraceParser *parser, const char *p, const char *end) {
+    long long fields[TRACE_FIELDS] = { 0 };
+    const char *reason = NULL;
+    
+    parser->burst_count = 0;
+    
+    while (p < end && is_blank(*p)) p++;
+    if (p == end || *p == '#') {
+        return;
+    }
+    if (!parser->seen_record && ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))) {
+        parser->seen_record = 1;
+        return;
+    }
+    parser->seen_record = 1;
+    
+    for (int f = 0; f < TRACE_FIELDS && reason == NULL; f++) {
+        while (p < end && is_blank(*p)) p++;
+        if (f >= TRACE_REQUIRED_FIELDS && p == end) {
+            break;
+        }
+        if (f > 0 && p < end && *p == ',') {
+            p++;
+            while (p < end && is_blank(*p)) p++;
+        }
+        reason = p == end ? "expected 4 to 6 fields (pid, arrival, burst, priority, deadline, period)"
+                          : parse_integer(&p, end, &fields[f]);
+        if (reason == NULL && p < end && *p == '/') {
+            reason = f == 2 ? parse_bursts(parser, &p, end, &fields[f]) : "unexpected character";
+        }
+    }
+    if (reason == NULL) {
+        while (p < end && is_blank(*p)) p++;
+        if (p != end) {
+            reason = "expected 4 to 6 fields (pid, arrival, burst, priority, deadline, period)";
+        }
+    }
+    if (reason == NULL) {
+        if (fields[0] < 0 || fields[0] > INT_MAX) {
+            reason = "pid out of range";
+        } else if (fields[1] < 0) {
+            reason = "arrival time must not be negative";
+        } else if (fields[2] <= 0) {
+            reason = "burst time must be positive";
+        } else if (fields[3] < INT_MIN || fields[3] > INT_MAX) {
+            reason = "priority out of range";
+        } else if (fields[4] < 0) {
+            reason = "deadline must not be negative";
+        } else if (fields[5] < 0) {
+            reason = "period must not be negative";
+        }
+    }
+    if (reason != NULL) {
+        reject_line(parser, parser->stats->lines, reason);
+        return;
+    }
+    
+    Process process;
+    memset(&process, 0, sizeof(Process));
+    process.pid = (int)fields[0];
+    process.arrival_time = fields[1];
+    process.burst_time = fields[2];
+    process.priority = (int)fields[3];
+    process.deadline = fields[4];
+    process.period = fields[5];
+    if (parser->burst_count > 1) {
+        process.bursts = parser->bursts;
+        process.burst_count = parser->burst_count;
+    }
+    process.remaining_time = process.burst_time;
+    process.response_time = -1;
+    
+    reason = parser->sink(parser->context, &process);
+    if (reason == TRACE_STOP) {
+        parser->stopped = 1;
+    } else if (reason != NULL) {
+        reject_line(parser, parser->stats->lines, reason);
+    } else {
+        parser->stats->records++;
+    }
+}
+
+// Reads what is available, up to size bytes. On a pipe this returns as soon
+// as some data arrives, so records are handed over while the stream is live.
+static long long read_chunk(FILE *file, char *buffer, size_t size) {
+#ifndef _WIN32
+    ssize_t got;
+    do {
+        got = read(fileno(file), buffer, size);
+    } while (got < 0 && errno == EINTR);
+    return got;
+#else
+    size_t got = fread(buffer, 1, size, file);
+    return got == 0 && ferror(file) ? -1 : (long long)got;
+#endif
+}
+
+int stream_trace(FILE *file, TraceSink sink, void *context, FILE *errors, TraceStats *stats) {
+    TraceParser parser = { sink, context, errors, stats, 0, 0, NULL, 0, 0 };
+    char *buffer = (char *)malloc(TRACE_CHUNK_SIZE);
+    size_t carried = 0;
+    int skipping = 0;       // Inside a line longer than the buffer
+    double start = wall_seconds();
+    
+    memset(stats, 0, sizeof(TraceStats));
+    if (buffer == NULL) {
+        return -1;
+    }
+    
+    int read_error = 0;
+    while (!parser.stopped) {
+        long long got = read_chunk(file, buffer + carried, TRACE_CHUNK_SIZE - carried);
+        if (got < 0) {
+            read_error = 1;
+            break;
+        }
+        const char *p = buffer;
+        const char *end = buffer + carried + got;
+        const char *newline;
+        
+        stats->bytes += got;
+        while (!parser.stopped && (newline = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+            stats->lines++;
+            if (skipping) {
+                skipping = 0;
+            } else {
+                parse_line(&parser, p, newline);
+            }
+            p = newline + 1;
+        }
+        
+        carried = (size_t)(end - p);
+        memmove(buffer, p, carried);
+        
+        if (got == 0) {
+            // Last line without a trailing newline
+            if (carried > 0 && !skipping) {
+                stats->lines++;
+                parse_line(&parser, buffer, buffer + carried);
+            }
+            break;
+        }
+        if (carried == TRACE_CHUNK_SIZE) {
+            if (!skipping) {
+                reject_line(&parser, stats->lines + 1, "line too long");
+                skipping = 1;
+            }
+            carried = 0;
+        }
+    }
+    
+    free(buffer);
+    free(parser.bursts);
+    stats->seconds = wall_seconds() - start;
+    if (parser.stopped || read_error) {
+        return -1;
+    }
+    return 0;
+}
+
+static const char *append_record(void *context, const Process *process) {
+    Process *slot = process_list_append((ProcessList *)context);
+    if (slot == NULL) {
+        return TRACE_STOP;
+    }
+    *slot = *process;
+    if (process->bursts != NULL) {
+        slot->bursts = process_list_copy_bursts((ProcessList *)context, process->bursts, process->burst_count);
+        if (slot->bursts == NULL) {
+            return TRACE_STOP;
+        }
+    }
+    return NULL;
+}
+
+int load_trace(FILE *file, ProcessList *list, FILE *errors, TraceStats *stats) {
+    return stream_trace(file, append_record, list, errors, stats);
+}
+
+int stream_trace_file(const char *path, TraceSink sink, void *context, FILE *errors, TraceStats *stats) {
+    if (strcmp(path, "-") == 0) {
+        return stream_trace(stdin, sink, context, errors, stats);
+    }
+    
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        memset(stats, 0, sizeof(TraceStats));
+        return -1;
+    }
+    int result = stream_trace(file, sink, context, errors, stats);
+    fclose(file);
+    return result;
+}
+
+int load_trace_file(const char *path, ProcessList *list, FILE *errors, TraceStats *stats) {
+    return stream_trace_file(path, append_record, list, errors, stats);
+}
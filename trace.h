@@ -0,0 +1,43 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "scheduling.h"
+#include <stdio.h>
+
+// Trace files hold one process per line: pid, arrival, burst, priority and
+// optionally a relative deadline and a period (0 for none). Fields are
+// separated by commas and/or blanks. Blank lines and lines
+// starting with '#' are ignored, as is a header line before the first record.
+// The burst may be a sequence of CPU and I/O bursts separated by '/', such
+// as 4/10/2 for 4 units of CPU, 10 of I/O and 2 more of CPU; the process's
+// burst time is then its CPU total.
+
+typedef struct {
+    long long lines;        // Lines read, including blanks and comments
+    long long bytes;        // Bytes read
+    int records;            // Records accepted
+    int rejected;           // Malformed lines that were skipped
+    double seconds;         // Wall-clock load time
+} TraceStats;
+
+// Receives each well-formed record; its burst sequence is only valid during
+// the call. Returns NULL to accept it, a reason to reject the line (reported
+// like a malformed line), or TRACE_STOP to stop reading, which makes the
+// load fail.
+typedef const char *(*TraceSink)(void *context, const Process *process);
+extern const char TRACE_STOP[];
+
+// Hands every well-formed record in file to sink as soon as its line has been
+// read. Returns 0 at end of file, -1 on a read error or TRACE_STOP.
+int stream_trace(FILE *file, TraceSink sink, void *context, FILE *errors, TraceStats *stats);
+int stream_trace_file(const char *path, TraceSink sink, void *context, FILE *errors, TraceStats *stats);
+
+// Appends every well-formed record in file to list. Malformed lines are
+// skipped and reported as "line N: reason" on errors (when not NULL).
+// Returns 0 on success, -1 on a read or allocation failure.
+int load_trace(FILE *file, ProcessList *list, FILE *errors, TraceStats *stats);
+
+// Same as load_trace() for a path; "-" reads standard input
+int load_trace_file(const char *path, ProcessList *list, FILE *errors, TraceStats *stats);
+
+#endif
@@ -0,0 +1,414 @@
+#include "workload.h"
+#include <limits.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+_Static_assert(sizeof(WorkloadHeader) == 64, "WorkloadHeader must be 64 bytes");
+_Static_assert(sizeof(int) == 4 && sizeof(long long) == 8, "fixed-width columns");
+
+static long long align8(long long offset) {
+    return (offset + 7) & ~7LL;
+}
+
+// Column offsets for count processes, with the timing columns if asked for
+static void layout_columns(WorkloadHeader *header, long long count, int timing) {
+    memset(header, 0, sizeof(WorkloadHeader));
+    memcpy(header->magic, WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC));
+    header->version = WORKLOAD_VERSION;
+    header->byte_order = WORKLOAD_BYTE_ORDER;
+    header->count = count;
+    header->pid_offset = sizeof(WorkloadHeader);
+    header->arrival_offset = align8(header->pid_offset + count * (long long)sizeof(int));
+    header->burst_offset = header->arrival_offset + count * (long long)sizeof(long long);
+    header->priority_offset = header->burst_offset + count * (long long)sizeof(long long);
+    if (timing) {
+        header->timing_offset = align8(header->priority_offset + count * (long long)sizeof(int));
+    }
+}
+
+static long long layout_size(const WorkloadHeader *header) {
+    if (header->timing_offset != 0) {
+        return header->timing_offset + 2 * header->count * (long long)sizeof(long long);
+    }
+    return header->priority_offset + header->count * (long long)sizeof(int);
+}
+
+// Points the columns into storage laid out as described by header
+static void attach_columns(Workload *workload, const WorkloadHeader *header, char *base) {
+    workload->n = (int)header->count;
+    workload->pid = (const int *)(base + header->pid_offset);
+    workload->arrival_time = (const long long *)(base + header->arrival_offset);
+    workload->burst_time = (const long long *)(base + header->burst_offset);
+    workload->priority = (const int *)(base + header->priority_offset);
+    workload->deadline = NULL;
+    workload->period = NULL;
+    workload->bursts = NULL;
+    workload->burst_start = NULL;
+    if (header->timing_offset != 0) {
+        workload->deadline = (const long long *)(base + header->timing_offset);
+        workload->period = workload->deadline + header->count;
+    }
+    workload->arrival_order = NULL;
+}
+
+int workload_check(const Workload *workload) {
+    for (int i = 0; i < workload->n; i++) {
+        if (workload->arrival_time[i] < 0 || workload->burst_time[i] <= 0) {
+            return WORKLOAD_ERR_INVALID;
+        }
+    }
+    if (workload->deadline != NULL) {
+        for (int i = 0; i < workload->n; i++) {
+            if (workload->deadline[i] < 0 || workload->period[i] < 0) {
+                return WORKLOAD_ERR_INVALID;
+            }
+        }
+    }
+    if (workload->bursts != NULL) {
+        for (int i = 0; i < workload->n; i++) {
+            long long count = workload->burst_start[i + 1] - workload->burst_start[i];
+            if (count % 2 == 0) {
+                return WORKLOAD_ERR_INVALID;
+            }
+        }
+        for (long long b = 0; b < workload->burst_start[workload->n]; b++) {
+            if (workload->bursts[b] <= 0) {
+                return WORKLOAD_ERR_INVALID;
+            }
+        }
+    }
+    return WORKLOAD_OK;
+}
+
+// Burst sequences only exist in memory. When any process has one, every
+// process gets one, after the file layout: n + 1 offsets, then the bursts.
+int workload_from_processes(Workload *workload, const Process *processes, int n) {
+    WorkloadHeader header;
+    int timing = 0;
+    long long burst_count = 0;
+    for (int i = 0; i < n; i++) {
+        timing |= processes[i].deadline != 0 || processes[i].period != 0;
+        burst_count += processes[i].bursts != NULL ? processes[i].burst_count : 1;
+    }
+    int bursts = burst_count > n;
+    layout_columns(&header, n, timing);
+    
+    long long size = align8(layout_size(&header));
+    if (bursts) {
+        size += (n + 1 + burst_count) * (long long)sizeof(long long);
+    }
+    char *base = (char *)malloc((size_t)size);
+    if (base == NULL) {
+        return WORKLOAD_ERR_MEMORY;
+    }
+    memcpy(base, &header, sizeof(WorkloadHeader));
+    
+    int *pid = (int *)(base + header.pid_offset);
+    long long *arrival_time = (long long *)(base + header.arrival_offset);
+    long long *burst_time = (long long *)(base + header.burst_offset);
+    int *priority = (int *)(base + header.priority_offset);
+    for (int i = 0; i < n; i++) {
+        pid[i] = processes[i].pid;
+        arrival_time[i] = processes[i].arrival_time;
+        burst_time[i] = processes[i].burst_time;
+        priority[i] = processes[i].priority;
+    }
+    if (timing) {
+        long long *deadline = (long long *)(base + header.timing_offset);
+        for (int i = 0; i < n; i++) {
+            deadline[i] = processes[i].deadline;
+            deadline[n + i] = processes[i].period;
+        }
+    }
+    
+    attach_columns(workload, &header, base);
+    if (bursts) {
+        long long *start = (long long *)(base + align8(layout_size(&header)));
+        long long *sequence = start + n + 1;
+        start[0] = 0;
+        for (int i = 0; i < n; i++) {
+            if (processes[i].bursts != NULL) {
+                memcpy(sequence + start[i], processes[i].bursts, processes[i].burst_count * sizeof(long long));
+                start[i + 1] = start[i] + processes[i].burst_count;
+            } else {
+                sequence[start[i]] = processes[i].burst_time;
+                start[i + 1] = start[i] + 1;
+            }
+        }
+        workload->burst_start = start;
+        workload->bursts = sequence;
+    }
+    workload->storage = base;
+    workload->mapped_size = 0;
+    int result = workload_check(workload);
+    if (result != WORKLOAD_OK) {
+        workload_free(workload);
+    }
+    return result;
+}
+
+static int check_header(const WorkloadHeader *header, long long file_size) {
+    WorkloadHeader expected;
+    
+    if (memcmp(header->magic, WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC)) != 0 ||
+        header->version != WORKLOAD_VERSION ||
+        header->byte_order != WORKLOAD_BYTE_ORDER) {
+        return WORKLOAD_ERR_FORMAT;
+    }
+    if (header->count < 0 || header->count > INT_MAX) {
+        return WORKLOAD_ERR_FORMAT;
+    }
+    
+    // Only the layout written by workload_write() is accepted
+    layout_columns(&expected, header->count, header->timing_offset != 0);
+    if (header->pid_offset != expected.pid_offset ||
+        header->arrival_offset != expected.arrival_offset ||
+        header->burst_offset != expected.burst_offset ||
+        header->priority_offset != expected.priority_offset ||
+        header->timing_offset != expected.timing_offset ||
+        layout_size(&expected) > file_size) {
+        return WORKLOAD_ERR_FORMAT;
+    }
+    return WORKLOAD_OK;
+}
+
+#ifndef _WIN32
+
+int workload_open(Workload *workload, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return WORKLOAD_ERR_IO;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return WORKLOAD_ERR_IO;
+    }
+    if (info.st_size < (off_t)sizeof(WorkloadHeader)) {
+        close(fd);
+        return WORKLOAD_ERR_FORMAT;
+    }
+    
+    void *mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return WORKLOAD_ERR_IO;
+    }
+    
+    const WorkloadHeader *header = (const WorkloadHeader *)mapping;
+    int result = check_header(header, (long long)info.st_size);
+    if (result == WORKLOAD_OK) {
+        attach_columns(workload, header, (char *)mapping);
+        workload->storage = mapping;
+        workload->mapped_size = (size_t)info.st_size;
+        result = workload_check(workload);
+    }
+    if (result != WORKLOAD_OK) {
+        munmap(mapping, (size_t)info.st_size);
+    }
+    return result;
+}
+
+void workload_free(Workload *workload) {
+    free(workload->arrival_order);
+    if (workload->mapped_size > 0) {
+        munmap(workload->storage, workload->mapped_size);
+    } else {
+        free(workload->storage);
+    }
+    memset(workload, 0, sizeof(Workload));
+}
+
+#else
+
+// No mmap: the file is read into memory in one piece
+int workload_open(Workload *workload, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return WORKLOAD_ERR_IO;
+    }
+    
+    WorkloadHeader header;
+    if (fread(&header, sizeof(WorkloadHeader), 1, file) != 1) {
+        fclose(file);
+        return WORKLOAD_ERR_FORMAT;
+    }
+    int result = check_header(&header, LLONG_MAX);
+    if (result != WORKLOAD_OK) {
+        fclose(file);
+        return result;
+    }
+    
+    size_t size = (size_t)layout_size(&header);
+    char *base = (char *)malloc(size);
+    if (base == NULL) {
+        fclose(file);
+        return WORKLOAD_ERR_MEMORY;
+    }
+    memcpy(base, &header, sizeof(WorkloadHeader));
+    size_t rest = size - sizeof(WorkloadHeader);
+    if (fread(base + sizeof(WorkloadHeader), 1, rest, file) != rest) {
+        free(base);
+        fclose(file);
+        return WORKLOAD_ERR_FORMAT;
+    }
+    fclose(file);
+    
+    attach_columns(workload, &header, base);
+    workload->storage = base;
+    workload->mapped_size = 0;
+    result = workload_check(workload);
+    if (result != WORKLOAD_OK) {
+        workload_free(workload);
+    }
+    return result;
+}
+
+void workload_free(Workload *workload) {
+    free(workload->arrival_order);
+    free(workload->storage);
+    memset(workload, 0, sizeof(Workload));
+}
+
+#endif
+
+typedef struct {
+    unsigned long long key;
+    int idx;
+} ArrivalKey;
+
+// Stable LSD radix sort on the arrival time, one byte per pass. Passes where
+// every key has the same byte are skipped, so small time ranges cost two or
+// three passes. Equal arrivals keep their index order.
+int workload_index(Workload *workload) {
+    int n = workload->n;
+    if (workload->arrival_order != NULL || n == 0) {
+        return WORKLOAD_OK;
+    }
+    
+    ArrivalKey *keys = (ArrivalKey *)malloc(n * sizeof(ArrivalKey));
+    ArrivalKey *scratch = (ArrivalKey *)malloc(n * sizeof(ArrivalKey));
+    int *order = (int *)malloc(n * sizeof(int));
+    if (keys == NULL || scratch == NULL || order == NULL) {
+        free(keys);
+        free(scratch);
+        free(order);
+        return WORKLOAD_ERR_MEMORY;
+    }
+    
+    // Flipping the sign bit makes unsigned order match signed order
+    int counts[8][256] = { { 0 } };
+    for (int i = 0; i < n; i++) {
+        keys[i].key = (unsigned long long)workload->arrival_time[i] ^ (1ULL << 63);
+        keys[i].idx = i;
+        for (int pass = 0; pass < 8; pass++) {
+            counts[pass][(keys[i].key >> (8 * pass)) & 0xFF]++;
+        }
+    }
+    
+    for (int pass = 0; pass < 8; pass++) {
+        int shift = 8 * pass;
+        if (counts[pass][(keys[0].key >> shift) & 0xFF] == n) {
+            continue;
+        }
+        
+        int position = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            int count = counts[pass][digit];
+            counts[pass][digit] = position;
+            position += count;
+        }
+        for (int i = 0; i < n; i++) {
+            scratch[counts[pass][(keys[i].key >> shift) & 0xFF]++] = keys[i];
+        }
+        
+        ArrivalKey *sorted = scratch;
+        scratch = keys;
+        keys = sorted;
+    }
+    
+    for (int i = 0; i < n; i++) {
+        order[i] = keys[i].idx;
+    }
+    free(keys);
+    free(scratch);
+    workload->arrival_order = order;
+    return WORKLOAD_OK;
+}
+
+// Writes zero padding up to offset, then the column
+static int write_column(FILE *file, long long *position, long long offset, const void *data, size_t size) {
+    static const char padding[8] = { 0 };
+    size_t gap = (size_t)(offset - *position);
+    
+    if (gap > 0 && fwrite(padding, 1, gap, file) != gap) {
+        return WORKLOAD_ERR_IO;
+    }
+    if (size > 0 && fwrite(data, 1, size, file) != size) {
+        return WORKLOAD_ERR_IO;
+    }
+    *position = offset + (long long)size;
+    return WORKLOAD_OK;
+}
+
+int workload_write(const Workload *workload, const char *path) {
+    if (workload->bursts != NULL) {
+        return WORKLOAD_ERR_BURSTS;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return WORKLOAD_ERR_IO;
+    }
+    
+    size_t n = (size_t)workload->n;
+    WorkloadHeader header;
+    layout_columns(&header, workload->n, workload->deadline != NULL);
+    long long position = sizeof(WorkloadHeader);
+    
+    int result = WORKLOAD_OK;
+    if (fwrite(&header, sizeof(WorkloadHeader), 1, file) != 1) {
+        result = WORKLOAD_ERR_IO;
+    }
+    if (result == WORKLOAD_OK) {
+        result = write_column(file, &position, header.pid_offset, workload->pid, n * sizeof(int));
+    }
+    if (result == WORKLOAD_OK) {
+        result = write_column(file, &position, header.arrival_offset, workload->arrival_time, n * sizeof(long long));
+    }
+    if (result == WORKLOAD_OK) {
+        result = write_column(file, &position, header.burst_offset, workload->burst_time, n * sizeof(long long));
+    }
+    if (result == WORKLOAD_OK) {
+        result = write_column(file, &position, header.priority_offset, workload->priority, n * sizeof(int));
+    }
+    if (result == WORKLOAD_OK && workload->deadline != NULL) {
+        result = write_column(file, &position, header.timing_offset, workload->deadline, n * sizeof(long long));
+    }
+    if (result == WORKLOAD_OK && workload->deadline != NULL) {
+        result = write_column(file, &position, header.timing_offset + (long long)(n * sizeof(long long)),
+                              workload->period, n * sizeof(long long));
+    }
+    if (fclose(file) != 0 && result == WORKLOAD_OK) {
+        result = WORKLOAD_ERR_IO;
+    }
+    return result;
+}
+
+const char *workload_error_string(int error) {
+    switch (error) {
+        case WORKLOAD_OK: return "success";
+        case WORKLOAD_ERR_IO: return "I/O error";
+        case WORKLOAD_ERR_FORMAT: return "not a workload file, truncated, or unsupported version";
+        case WORKLOAD_ERR_MEMORY: return "out of memory";
+        case WORKLOAD_ERR_INVALID: return "negative arrival, deadline or period, or non-positive burst";
+        case WORKLOAD_ERR_BURSTS: return "burst sequences cannot be stored in a binary workload";
+        default: return "unknown error";
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "scheduling.h"
+
+// Binary workload file, version 1 (native byte order):
+//
+//   WorkloadHeader (64 bytes)
+//   int       pid[count]
+//   long long arrival_time[count]   8-byte aligned
+//   long long burst_time[count]
+//   int       priority[count]
+//   long long deadline[count]       8-byte aligned; only if timing_offset != 0
+//   long long period[count]
+//
+// Offsets in the header are from the start of the file, so the columns can be
+// used in place from a read-only mapping. Files without deadlines or periods
+// leave timing_offset at 0 and end after the priority column. CPU and I/O
+// burst sequences have no place in the format; they only come from traces.
+
+#define WORKLOAD_MAGIC "SCHEDWL"
+#define WORKLOAD_VERSION 1
+#define WORKLOAD_BYTE_ORDER 0x01020304
+
+typedef struct {
+    char magic[8];
+    unsigned int version;
+    unsigned int byte_order;
+    long long count;
+    long long pid_offset;
+    long long arrival_offset;
+    long long burst_offset;
+    long long priority_offset;
+    long long timing_offset;        // Deadline column, followed by the period column
+} WorkloadHeader;
+
+#define WORKLOAD_OK 0
+#define WORKLOAD_ERR_IO -1
+#define WORKLOAD_ERR_FORMAT -2
+#define WORKLOAD_ERR_MEMORY -3
+#define WORKLOAD_ERR_INVALID -4
+#define WORKLOAD_ERR_BURSTS -5          // workload_write() of burst sequences
+
+// Builds a workload with its own copy of the process columns. Fails with
+// WORKLOAD_ERR_INVALID, leaving the workload empty, as workload_check() does.
+int workload_from_processes(Workload *workload, const Process *processes, int n);
+
+// WORKLOAD_ERR_INVALID unless every arrival is non-negative, every burst
+// positive (I/O bursts included), and every deadline and period 0 (none) or
+// positive. Every algorithm depends on this.
+int workload_check(const Workload *workload);
+
+// Maps a binary workload file read-only and checks its contents
+int workload_open(Workload *workload, const char *path);
+
+// Writes workload in the binary format
+int workload_write(const Workload *workload, const char *path);
+
+// Builds the arrival index shared by all algorithms. It is kept in the
+// workload, so later calls (and later runs) reuse it.
+int workload_index(Workload *workload);
+
+// Releases the columns (heap memory or mapping) and the arrival index
+void workload_free(Workload *workload);
+
+const char *workload_error_string(int error);
+
+#endif